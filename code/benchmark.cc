@@ -0,0 +1,828 @@
+#include "benchmark.h"
+
+#include "ns3/core-module.h"
+
+#include <map>
+#include <list>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <iostream>
+#include <cstring>
+#include <unistd.h>
+#include <algorithm>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+#include "utilities.h"
+#include "grid-index.h"
+#include "node-registry.h"
+#include "kernel-benchmark.h"
+#include "session-table.h"
+#include "service-path.h"
+#include "radius-filter.h"
+#include "service-catalog.h"
+#include "wire-format.h"
+#include "central-matcher.h"
+#include "search-error-header.h"
+#include "search-notification-header.h"
+#include "position-application.h"
+#include "ontology-application.h"
+
+NS_LOG_COMPONENT_DEFINE("Benchmark");
+
+/*
+ * Returns whether every check of the benchmark passed, the results are printed either way.
+ */
+bool Benchmark::Run(std::string name, std::vector<int> sizes) {
+	NS_LOG_FUNCTION(name);
+	bool passed = true;
+	if(name.compare("spatialIndex") == 0) {
+		passed = RunSpatialIndex();
+	} else if(name.compare("scheduleSelection") == 0) {
+		passed = RunScheduleSelection();
+	} else if(name.compare("notificationMemory") == 0) {
+		passed = RunNotificationMemory();
+	} else if(name.compare("wireFormat") == 0) {
+		passed = RunWireFormat();
+	} else if(name.compare("randomDraw") == 0) {
+		passed = RunRandomDraw();
+	} else if(name.compare("sessionTable") == 0) {
+		passed = RunSessionTable();
+	} else if(name.compare("servicePaths") == 0) {
+		passed = RunServicePaths();
+	} else if(name.compare("nodeTable") == 0) {
+		passed = RunNodeTable();
+	} else if(name.compare("radiusFilter") == 0) {
+		passed = RunRadiusFilter();
+	} else if(name.compare("expiry") == 0) {
+		passed = RunExpiry();
+	} else if(name.compare("serviceIndex") == 0) {
+		passed = RunServiceIndex();
+	} else if(name.compare("kernels") == 0) {
+		KernelBenchmark::Run(sizes, std::cout);
+	} else {
+		std::cerr << "Unknown benchmark " << name << std::endl;
+		passed = false;
+	}
+	return passed;
+}
+
+POSITION Benchmark::GetRandomPosition(double areaSize) {
+	POSITION position;
+	position.x = Utilities::Random(0, areaSize);
+	position.y = Utilities::Random(0, areaSize);
+	return position;
+}
+
+bool Benchmark::RunSpatialIndex() {
+	NS_LOG_FUNCTION_NOARGS();
+	const int nQueries = 1000;
+	const int sizes[] = {1000, 10000, 100000};
+	bool passed = true;
+	for(int s = 0; s < 3; s++) {
+		GridIndex grid;
+		std::map<uint, POSITION> positions;
+		//Grow the area with the fleet so density stays the one of the default scenario
+		double areaSize = MAX_DISTANCE * sqrt(sizes[s] / (double) TOTAL_NUMBER_OF_NODES);
+		for(int i = 0; i < sizes[s]; i++) {
+			positions[i] = GetRandomPosition(areaSize);
+			grid.Update(i, positions[i]);
+		}
+		std::vector<double> distances;
+		std::vector<POSITION> centers;
+		for(int i = 0; i < nQueries; i++) {
+			centers.push_back(GetRandomPosition(areaSize));
+			distances.push_back(Utilities::Random(MIN_REQUEST_DISTANCE, MAX_REQUEST_DISTANCE));
+		}
+		long linearFound = 0;
+		double start = Utilities::GetWallClockTime();
+		for(int q = 0; q < nQueries; q++) {
+			for(std::map<uint, POSITION>::iterator i = positions.begin(); i != positions.end(); i++) {
+				if(PositionApplication::CalculateDistanceFromTo(i->second, centers[q]) <= distances[q]) {
+					linearFound++;
+				}
+			}
+		}
+		double linearTime = Utilities::GetWallClockTime() - start;
+		long indexFound = 0;
+		start = Utilities::GetWallClockTime();
+		for(int q = 0; q < nQueries; q++) {
+			indexFound += grid.GetNodesInRange(centers[q], distances[q]).size();
+		}
+		double indexTime = Utilities::GetWallClockTime() - start;
+		std::cout << "spatialIndex nodes=" << sizes[s] << " area=" << areaSize << "m"
+				<< " linear=" << (linearTime * 1000000 / nQueries) << "us/query"
+				<< " index=" << (indexTime * 1000000 / nQueries) << "us/query"
+				<< " speedup=" << (linearTime / indexTime) << "x"
+				<< " match=" << (linearFound == indexFound ? "yes" : "no") << std::endl;
+		passed = passed && linearFound == indexFound;
+	}
+	return passed;
+}
+
+bool Benchmark::RunScheduleSelection() {
+	NS_LOG_FUNCTION_NOARGS();
+	const int nRequests = 20;
+	const int nCandidates = 10000;
+	bool passed = true;
+	CentralMatcher matcher;
+	//Registered in order, so node i is in slot i - 1
+	std::vector<int> nodes;
+	for(int i = 1; i <= nCandidates; i++) {
+		std::list<std::string> offeredServices;
+		offeredServices.push_back(OntologyApplication::GetRandomService());
+		offeredServices.push_back(OntologyApplication::GetRandomService());
+		matcher.registry.Update(i, GetRandomPosition(MAX_DISTANCE), offeredServices, 0);
+		nodes.push_back(i - 1);
+	}
+	matcher.registry.Publish();
+	int ticket;
+	const REGISTRY_SNAPSHOT *snapshot = matcher.registry.Acquire(ticket);
+	std::vector<SearchRequestHeader> requests(nRequests);
+	for(int i = 0; i < nRequests; i++) {
+		requests[i].SetRequestedService(OntologyApplication::GetRandomService());
+	}
+	for(int nSchedule = 1; nSchedule <= 5; nSchedule++) {
+		matcher.MAX_SCHEDULE_SIZE = nSchedule;
+		bool match = true;
+		std::vector<std::list<uint> > schedules(nRequests);
+		double start = Utilities::GetWallClockTime();
+		for(int i = 0; i < nRequests; i++) {
+			schedules[i] = matcher.GetScheduleNodesIteratively(snapshot, nodes, requests[i]);
+		}
+		double iterativeTime = Utilities::GetWallClockTime() - start;
+		start = Utilities::GetWallClockTime();
+		for(int i = 0; i < nRequests; i++) {
+			match = match && schedules[i] == matcher.GetScheduleNodesSinglePass(snapshot, nodes, requests[i]);
+		}
+		double singlePassTime = Utilities::GetWallClockTime() - start;
+		std::cout << "scheduleSelection candidates=" << nCandidates << " nSchedule=" << nSchedule
+				<< " iterative=" << (iterativeTime * 1000000 / nRequests) << "us/request"
+				<< " singlePass=" << (singlePassTime * 1000000 / nRequests) << "us/request"
+				<< " speedup=" << (iterativeTime / singlePassTime) << "x"
+				<< " match=" << (match ? "yes" : "no") << std::endl;
+		passed = passed && match;
+	}
+	matcher.registry.Release(ticket);
+	return passed;
+}
+
+bool Benchmark::RunNotificationMemory() {
+	NS_LOG_FUNCTION_NOARGS();
+	const int nWarmup = 10000;
+	const int nNotifications = 1000000;
+	SearchNotificationHeader notification;
+	std::list<std::string> offeredServices;
+	offeredServices.push_back(OntologyApplication::GetRandomService());
+	offeredServices.push_back(OntologyApplication::GetRandomService());
+	offeredServices.push_back("/not/in/the/catalog");
+	notification.SetOfferedServices(offeredServices);
+	notification.SetCurrentPosition(GetRandomPosition(MAX_DISTANCE));
+	Buffer buffer;
+	buffer.AddAtStart(notification.GetSerializedSize());
+	notification.Serialize(buffer.Begin());
+	SearchNotificationHeader received;
+	long checksum = 0;
+	for(int i = 0; i < nWarmup; i++) {
+		checksum += received.Deserialize(buffer.Begin());
+	}
+	long startMemory = Utilities::GetResidentMemory();
+	double start = Utilities::GetWallClockTime();
+	for(int i = 0; i < nNotifications; i++) {
+		checksum += received.Deserialize(buffer.Begin());
+	}
+	double time = Utilities::GetWallClockTime() - start;
+	long growth = Utilities::GetResidentMemory() - startMemory;
+	bool match = received.GetOfferedServices() == offeredServices && checksum == (long) (nWarmup + nNotifications) * notification.GetSerializedSize();
+	//A leak of even one int per notification would show up as megabytes here
+	bool flat = growth < 1024;
+	std::cout << "notificationMemory notifications=" << nNotifications
+			<< " deserialize=" << (time * 1000000000 / nNotifications) << "ns/notification"
+			<< " rssGrowth=" << growth << "KB"
+			<< " flat=" << (flat ? "yes" : "no")
+			<< " match=" << (match ? "yes" : "no") << std::endl;
+	return match && flat;
+}
+
+template <class T> T Benchmark::RoundTrip(T header) {
+	Buffer buffer;
+	buffer.AddAtStart(header.GetSerializedSize());
+	header.Serialize(buffer.Begin());
+	T received;
+	received.Deserialize(buffer.Begin());
+	return received;
+}
+
+/*
+ * Round-trips random headers through the wire format, which must keep every timestamp and stay
+ * within one fixed point step of every position and distance. The worst error is compared with the
+ * previous encoding, which truncated coordinates to U32.
+ */
+bool Benchmark::RunWireFormat() {
+	NS_LOG_FUNCTION_NOARGS();
+	const int nHeaders = 100000;
+	POSITION origin;
+	origin.x = MAX_DISTANCE / 2;
+	origin.y = MAX_DISTANCE / 2;
+	WireFormat::SetOrigin(origin);
+	double maxError = 0;
+	double maxTruncationError = 0;
+	bool match = true;
+	SearchRequestHeader request;
+	SearchErrorHeader error;
+	SearchResponseHeader response;
+	SearchNotificationHeader notification;
+	std::list<std::string> offeredServices;
+	offeredServices.push_back(OntologyApplication::GetRandomService());
+	notification.SetOfferedServices(offeredServices);
+	VELOCITY velocity;
+	velocity.x = 1.5;
+	velocity.y = -2.25;
+	notification.SetVelocity(velocity);
+	for(int i = 0; i < nHeaders; i++) {
+		POSITION position = GetRandomPosition(MAX_DISTANCE);
+		//Microsecond resolution timestamps, in milliseconds, well beyond what fits in a U32
+		double timestamp = floor(Utilities::Random(0, 1e13)) / 1000;
+		double distance = Utilities::Random(MIN_REQUEST_DISTANCE, MAX_REQUEST_DISTANCE);
+		request.SetRequestPosition(position);
+		request.SetRequestTimestamp(timestamp);
+		request.SetMaxDistanceAllowed(distance);
+		SearchRequestHeader receivedRequest = RoundTrip(request);
+		POSITION receivedPosition = receivedRequest.GetRequestPosition();
+		maxError = std::max(maxError, std::max(fabs(receivedPosition.x - position.x), fabs(receivedPosition.y - position.y)));
+		maxError = std::max(maxError, fabs(receivedRequest.GetMaxDistanceAllowed() - distance));
+		maxTruncationError = std::max(maxTruncationError, std::max(position.x - (uint32_t) position.x, position.y - (uint32_t) position.y));
+		match = match && receivedRequest.GetRequestTimestamp() == timestamp;
+		response.SetDistance(distance);
+		response.SetRequestTimestamp(timestamp);
+		SearchResponseHeader receivedResponse = RoundTrip(response);
+		maxError = std::max(maxError, fabs(receivedResponse.GetDistance() - distance));
+		match = match && receivedResponse.GetRequestTimestamp() == timestamp;
+		error.SetRequestTimestamp(timestamp);
+		match = match && RoundTrip(error).GetRequestTimestamp() == timestamp;
+		notification.SetCurrentPosition(position);
+		notification.SetNotificationTimestamp(timestamp);
+		SearchNotificationHeader receivedNotification = RoundTrip(notification);
+		receivedPosition = receivedNotification.GetCurrentPosition();
+		maxError = std::max(maxError, std::max(fabs(receivedPosition.x - position.x), fabs(receivedPosition.y - position.y)));
+		match = match && receivedNotification.GetNotificationTimestamp() == timestamp && receivedNotification.GetOfferedServices() == offeredServices;
+	}
+	match = match && RoundTrip(SearchResponseHeader()).GetDistance() == std::numeric_limits<double>::max();
+	bool bounded = maxError <= 1 / 65536.0;
+	std::cout << "wireFormat headers=" << nHeaders
+			<< " maxError=" << maxError << "m"
+			<< " previousMaxError=" << maxTruncationError << "m"
+			<< " bounded=" << (bounded ? "yes" : "no")
+			<< " match=" << (match ? "yes" : "no") << std::endl;
+	std::cout << "wireFormat request=" << request.GetSerializedSize() << "B"
+			<< " response=" << response.GetSerializedSize() << "B"
+			<< " error=" << error.GetSerializedSize() << "B"
+			<< " notification=" << notification.GetSerializedSize() << "B" << std::endl;
+	return match && bounded;
+}
+
+/*
+ * Compares drawing from a new random variable on every call, as Utilities::Random used to, with
+ * the cached streams, both alone and as the jitter of chains of events run by the simulator. The
+ * cached jitter must stay in its range with the mean of a uniform draw, and every event must run.
+ */
+bool Benchmark::RunRandomDraw() {
+	NS_LOG_FUNCTION_NOARGS();
+	const int nDraws = 1000000;
+	const int nEvents = 1000000;
+	double freshSum = 0;
+	double start = Utilities::GetWallClockTime();
+	for(int i = 0; i < nDraws; i++) {
+		Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable>();
+		freshSum += random->GetValue(MIN_JITTER, MAX_JITTER);
+	}
+	double freshTime = Utilities::GetWallClockTime() - start;
+	double sum = 0;
+	bool inRange = true;
+	start = Utilities::GetWallClockTime();
+	for(int i = 0; i < nDraws; i++) {
+		double jitter = Utilities::GetJitter();
+		inRange = inRange && jitter >= MIN_JITTER && jitter <= MAX_JITTER;
+		sum += jitter;
+	}
+	double cachedTime = Utilities::GetWallClockTime() - start;
+	//The standard error of the mean is under a thousandth of the range here
+	double meanJitter = sum / nDraws;
+	bool uniform = inRange && fabs(meanJitter - (MIN_JITTER + MAX_JITTER) / 2) < (MAX_JITTER - MIN_JITTER) / 100;
+	std::cout << "randomDraw draws=" << nDraws
+			<< " fresh=" << freshTime * 1e9 / nDraws << "ns"
+			<< " cached=" << cachedTime * 1e9 / nDraws << "ns"
+			<< " speedup=" << freshTime / cachedTime
+			<< " freshMeanJitter=" << freshSum / nDraws << "s"
+			<< " meanJitter=" << meanJitter << "s"
+			<< " uniform=" << (uniform ? "yes" : "no") << std::endl;
+	double freshEvents = RunJitterEvents(nEvents, false);
+	bool ran = remainingEvents == 0;
+	double cachedEvents = RunJitterEvents(nEvents, true);
+	ran = ran && remainingEvents == 0;
+	std::cout << "randomDraw events=" << nEvents
+			<< " fresh=" << freshEvents << "events/s"
+			<< " cached=" << cachedEvents << "events/s"
+			<< " speedup=" << cachedEvents / freshEvents
+			<< " ran=" << (ran ? "yes" : "no") << std::endl;
+	return uniform && ran;
+}
+
+int Benchmark::remainingEvents = 0;
+
+double Benchmark::RunJitterEvents(int nEvents, bool cached) {
+	NS_LOG_FUNCTION(nEvents << cached);
+	remainingEvents = nEvents;
+	double start = Utilities::GetWallClockTime();
+	//As many chains as nodes in the default scenario, so the event queue has a realistic size
+	for(int i = 0; i < TOTAL_NUMBER_OF_NODES; i++) {
+		Simulator::Schedule(Seconds(0), &Benchmark::JitterEvent, cached);
+	}
+	Simulator::Run();
+	double elapsed = Utilities::GetWallClockTime() - start;
+	Simulator::Destroy();
+	return nEvents / elapsed;
+}
+
+void Benchmark::JitterEvent(bool cached) {
+	if(remainingEvents <= 0) {
+		return;
+	}
+	remainingEvents--;
+	double jitter;
+	if(cached) {
+		jitter = Utilities::GetJitter();
+	} else {
+		jitter = CreateObject<UniformRandomVariable>()->GetValue(MIN_JITTER, MAX_JITTER);
+	}
+	Simulator::Schedule(Seconds(jitter), &Benchmark::JitterEvent, cached);
+}
+
+/*
+ * Churns through many short sessions with a bounded number alive at once, like a long simulation,
+ * checking the table against a map and that the cost per session and the memory do not grow.
+ */
+bool Benchmark::RunSessionTable() {
+	NS_LOG_FUNCTION_NOARGS();
+	const int nSessions = 1000000;
+	const int nAlive = 64;
+	const int nLookups = 20;
+	const int nPhases = 10;
+	SessionTable sessions;
+	std::map<SESSION_KEY, int> reference;
+	std::list<SESSION_KEY> alive;
+	bool match = true;
+	long startMemory = 0;
+	double firstPhaseTime = 0;
+	double lastPhaseTime = 0;
+	for(int phase = 0; phase < nPhases; phase++) {
+		double start = Utilities::GetWallClockTime();
+		for(int i = 0; i < nSessions / nPhases; i++) {
+			SESSION_KEY key = std::make_pair((uint) Utilities::Random(0, 10000), (int) Utilities::Random(0, BUILT_IN_NUMBER_OF_SERVICES));
+			sessions.Get(key).packets++;
+			reference[key]++;
+			alive.push_back(key);
+			for(int j = 0; j < nLookups; j++) {
+				sessions.Find(key)->packets += 0;
+			}
+			if((int) alive.size() > nAlive) {
+				SESSION_KEY oldest = alive.front();
+				alive.pop_front();
+				//The same key may be alive more than once, it is only released with the last one
+				if(std::find(alive.begin(), alive.end(), oldest) == alive.end()) {
+					SERVICE_SESSION *session = sessions.Find(oldest);
+					match = match && session != NULL && session->packets == reference[oldest];
+					sessions.Erase(oldest);
+					reference.erase(oldest);
+				}
+			}
+		}
+		double time = Utilities::GetWallClockTime() - start;
+		if(phase == 0) {
+			firstPhaseTime = time;
+			startMemory = Utilities::GetResidentMemory();
+		}
+		lastPhaseTime = time;
+	}
+	long growth = Utilities::GetResidentMemory() - startMemory;
+	match = match && sessions.GetSize() == (int) reference.size();
+	for(std::map<SESSION_KEY, int>::iterator i = reference.begin(); i != reference.end(); i++) {
+		match = match && sessions.Find(i->first) != NULL && sessions.Find(i->first)->packets == i->second;
+	}
+	bool flat = growth < 1024;
+	std::cout << "sessionTable sessions=" << nSessions << " alive=" << nAlive
+			<< " firstPhase=" << (firstPhaseTime * 1000000000 / (nSessions / nPhases)) << "ns/session"
+			<< " lastPhase=" << (lastPhaseTime * 1000000000 / (nSessions / nPhases)) << "ns/session"
+			<< " size=" << sessions.GetSize() << " capacity=" << sessions.GetCapacity()
+			<< " rssGrowth=" << growth << "KB"
+			<< " flat=" << (flat ? "yes" : "no")
+			<< " match=" << (match ? "yes" : "no") << std::endl;
+	return match && flat;
+}
+
+/*
+ * Checks the packed semantic distance, single and in a batch, against the string implementation on
+ * every pair of services of the built-in catalog, of a complete ontology tree and of the deepest
+ * paths that can be packed, then loads the tree as a catalog to check the table built from them.
+ */
+bool Benchmark::RunServicePaths() {
+	NS_LOG_FUNCTION_NOARGS();
+	const int nDigits = 4;
+	const int maxDepth = 5;
+	std::vector<std::string> services;
+	for(int i = 0; i < ServiceCatalog::GetSize(); i++) {
+		services.push_back(ServiceCatalog::GetService(i));
+	}
+	std::list<std::string> level(1, "");
+	for(int depth = 1; depth <= maxDepth; depth++) {
+		std::list<std::string> nextLevel;
+		for(std::list<std::string>::iterator i = level.begin(); i != level.end(); i++) {
+			for(int digit = 0; digit < nDigits; digit++) {
+				nextLevel.push_back(*i + (char) ('0' + digit));
+			}
+		}
+		services.insert(services.end(), nextLevel.begin(), nextLevel.end());
+		level = nextLevel;
+	}
+	services.push_back(std::string(MAX_SERVICE_PATH_DEPTH, '0'));
+	services.push_back(std::string(MAX_SERVICE_PATH_DEPTH, '9'));
+	services.push_back(std::string(MAX_SERVICE_PATH_DEPTH - 1, '0') + "9");
+	services.push_back("9" + std::string(MAX_SERVICE_PATH_DEPTH - 1, '0'));
+	int size = services.size();
+	std::vector<SERVICE_PATH> paths(size);
+	bool packed = true;
+	for(int i = 0; i < size; i++) {
+		packed = ServicePath::Pack(services[i], paths[i]) && packed;
+	}
+	SERVICE_PATH path;
+	bool rejected = !ServicePath::Pack(std::string(MAX_SERVICE_PATH_DEPTH + 1, '0'), path) && !ServicePath::Pack("01a", path);
+	std::vector<int> expected(size * size);
+	double start = Utilities::GetWallClockTime();
+	for(int i = 0; i < size; i++) {
+		for(int j = 0; j < size; j++) {
+			expected[i * size + j] = ServiceCatalog::CalculateSemanticDistance(services[i], services[j]);
+		}
+	}
+	double stringTime = Utilities::GetWallClockTime() - start;
+	bool match = true;
+	start = Utilities::GetWallClockTime();
+	for(int i = 0; i < size; i++) {
+		for(int j = 0; j < size; j++) {
+			match = ServicePath::SemanticDistance(paths[i], paths[j]) == expected[i * size + j] && match;
+		}
+	}
+	double packedTime = Utilities::GetWallClockTime() - start;
+	std::vector<int> distances(size);
+	bool batchMatch = true;
+	double batchTime = 0;
+	for(int i = 0; i < size; i++) {
+		start = Utilities::GetWallClockTime();
+		ServicePath::SemanticDistances(paths[i], &paths[0], size, &distances[0]);
+		batchTime += Utilities::GetWallClockTime() - start;
+		batchMatch = batchMatch && std::equal(distances.begin(), distances.end(), expected.begin() + i * size);
+	}
+	//Last, since it replaces the catalog
+	ServiceCatalog::Load(services);
+	bool tableMatch = true;
+	for(int i = 0; i < size; i++) {
+		for(int j = 0; j < size; j++) {
+			tableMatch = tableMatch && ServiceCatalog::SemanticDistance(ServiceCatalog::GetServiceId(services[i]), ServiceCatalog::GetServiceId(services[j])) == expected[i * size + j];
+		}
+	}
+	double nPairs = (double) size * size;
+	std::cout << "servicePaths services=" << size << " pairs=" << (long) nPairs
+			<< " string=" << stringTime * 1e9 / nPairs << "ns"
+			<< " packed=" << packedTime * 1e9 / nPairs << "ns"
+			<< " batch=" << batchTime * 1e9 / nPairs << "ns"
+			<< " packable=" << (packed && rejected ? "yes" : "no")
+			<< " match=" << (match ? "yes" : "no")
+			<< " batchMatch=" << (batchMatch ? "yes" : "no")
+			<< " tableMatch=" << (tableMatch ? "yes" : "no") << std::endl;
+	return packed && rejected && match && batchMatch && tableMatch;
+}
+
+/*
+ * Hardware counter of the cache misses of this thread, or -1 where perf events are not available.
+ */
+int Benchmark::OpenCacheMissCounter() {
+	struct perf_event_attr attributes;
+	memset(&attributes, 0, sizeof(attributes));
+	attributes.size = sizeof(attributes);
+	attributes.type = PERF_TYPE_HARDWARE;
+	attributes.config = PERF_COUNT_HW_CACHE_MISSES;
+	attributes.disabled = 1;
+	attributes.exclude_kernel = 1;
+	attributes.exclude_hv = 1;
+	int counter = syscall(__NR_perf_event_open, &attributes, 0, -1, -1, 0);
+	if(counter >= 0) {
+		ioctl(counter, PERF_EVENT_IOC_RESET, 0);
+		ioctl(counter, PERF_EVENT_IOC_ENABLE, 0);
+	}
+	return counter;
+}
+
+long Benchmark::ReadCounter(int counter) {
+	long long value = -1;
+	if(counter >= 0) {
+		ioctl(counter, PERF_EVENT_IOC_DISABLE, 0);
+		if(read(counter, &value, sizeof(value)) != sizeof(value)) {
+			value = -1;
+		}
+		close(counter);
+	}
+	return value;
+}
+
+/*
+ * Full scans of the registry, as done without the spatial index: the radius filter and the scoring of
+ * the nodes in range, over the maps the registry used to keep and over the node table. Nodes register
+ * in random order with their service lists allocated in between, as they arrive in a simulation.
+ */
+bool Benchmark::RunNodeTable() {
+	NS_LOG_FUNCTION_NOARGS();
+	const int nRequests = 200;
+	const int sizes[] = {10000, 50000, 200000};
+	bool passed = true;
+	for(int s = 0; s < 3; s++) {
+		int nNodes = sizes[s];
+		double areaSize = MAX_DISTANCE * sqrt(nNodes / (double) TOTAL_NUMBER_OF_NODES);
+		std::vector<uint> addresses(nNodes);
+		for(int i = 0; i < nNodes; i++) {
+			addresses[i] = i + 1;
+		}
+		std::random_shuffle(addresses.begin(), addresses.end());
+		CentralMatcher matcher;
+		matcher.SetSpatialIndex(false);
+		std::map<uint, POSITION> positions;
+		std::map<uint, std::vector<int> > serviceIds;
+		std::map<uint, std::list<std::string> > services;
+		for(int i = 0; i < nNodes; i++) {
+			POSITION position = GetRandomPosition(areaSize);
+			std::list<std::string> offeredServices;
+			offeredServices.push_back(OntologyApplication::GetRandomService());
+			offeredServices.push_back(OntologyApplication::GetRandomService());
+			positions[addresses[i]] = position;
+			services[addresses[i]] = offeredServices;
+			serviceIds[addresses[i]] = ServiceCatalog::GetServiceIds(offeredServices);
+			matcher.registry.Update(addresses[i], position, offeredServices, 0);
+		}
+		matcher.registry.Publish();
+		std::vector<SearchRequestHeader> requests(nRequests);
+		for(int i = 0; i < nRequests; i++) {
+			requests[i].SetRequestPosition(GetRandomPosition(areaSize));
+			requests[i].SetMaxDistanceAllowed(Utilities::Random(MIN_REQUEST_DISTANCE, MAX_REQUEST_DISTANCE));
+			requests[i].SetRequestedService(OntologyApplication::GetRandomService());
+		}
+		std::vector<std::list<uint> > schedules(nRequests);
+		int counter = OpenCacheMissCounter();
+		double start = Utilities::GetWallClockTime();
+		for(int r = 0; r < nRequests; r++) {
+			POSITION requestPosition = requests[r].GetRequestPosition();
+			int requestedServiceId = ServiceCatalog::GetServiceId(requests[r].GetRequestedService());
+			std::vector<SCHEDULE_CANDIDATE> candidates;
+			for(std::map<uint, POSITION>::iterator i = positions.begin(); i != positions.end(); i++) {
+				if(PositionApplication::CalculateDistanceFromTo(i->second, requestPosition) <= requests[r].GetMaxDistanceAllowed()) {
+					const std::vector<int> &ids = serviceIds.find(i->first)->second;
+					SCHEDULE_CANDIDATE candidate;
+					candidate.address = i->first;
+					candidate.semanticDistance = OntologyApplication::GetBestOfferedService(requestedServiceId, &ids[0], ids.size()).semanticDistance;
+					candidates.push_back(candidate);
+				}
+			}
+			int nSchedule = std::min((int) candidates.size(), matcher.MAX_SCHEDULE_SIZE);
+			std::partial_sort(candidates.begin(), candidates.begin() + nSchedule, candidates.end(), CentralMatcher::IsBetterCandidate);
+			for(int i = 0; i < nSchedule; i++) {
+				schedules[r].push_back(candidates[i].address);
+			}
+		}
+		double mapTime = Utilities::GetWallClockTime() - start;
+		long mapMisses = ReadCounter(counter);
+		int ticket;
+		const REGISTRY_SNAPSHOT *snapshot = matcher.registry.Acquire(ticket);
+		bool match = true;
+		counter = OpenCacheMissCounter();
+		start = Utilities::GetWallClockTime();
+		for(int r = 0; r < nRequests; r++) {
+			match = matcher.GetScheduleNodes(snapshot, matcher.FilterNodesByDistance(snapshot, requests[r]), requests[r]) == schedules[r] && match;
+		}
+		double tableTime = Utilities::GetWallClockTime() - start;
+		long tableMisses = ReadCounter(counter);
+		matcher.registry.Release(ticket);
+		std::cout << "nodeTable nodes=" << nNodes
+				<< " maps=" << (mapTime * 1000000 / nRequests) << "us/request"
+				<< " table=" << (tableTime * 1000000 / nRequests) << "us/request"
+				<< " speedup=" << (mapTime / tableTime) << "x";
+		if(mapMisses >= 0 && tableMisses >= 0) {
+			std::cout << " mapMisses=" << mapMisses / nRequests << "/request"
+					<< " tableMisses=" << tableMisses / nRequests << "/request";
+		} else {
+			std::cout << " cacheMisses=unavailable";
+		}
+		std::cout << " match=" << (match ? "yes" : "no") << std::endl;
+		passed = passed && match;
+	}
+	return passed;
+}
+
+/*
+ * Every implementation of the radius filter the CPU supports against the distances of
+ * PositionApplication, on random circles and on circles with a point exactly on their edge.
+ */
+bool Benchmark::RunRadiusFilter() {
+	NS_LOG_FUNCTION_NOARGS();
+	const int nQueries = 200;
+	const int sizes[] = {1000, 10000, 100000};
+	bool passed = true;
+	const char *names[] = {"scalar", "sse2", "avx2"};
+	RADIUS_FILTER filters[] = {&RadiusFilter::FilterScalar, &RadiusFilter::FilterSse2, &RadiusFilter::FilterAvx2};
+	std::string instructionSet = RadiusFilter::GetInstructionSet();
+	int nFilters = instructionSet == "avx2" ? 3 : instructionSet == "sse2" ? 2 : 1;
+	for(int s = 0; s < 3; s++) {
+		int nPoints = sizes[s];
+		double areaSize = MAX_DISTANCE * sqrt(nPoints / (double) TOTAL_NUMBER_OF_NODES);
+		std::vector<double> x(nPoints);
+		std::vector<double> y(nPoints);
+		for(int i = 0; i < nPoints; i++) {
+			x[i] = Utilities::Random(0, areaSize);
+			y[i] = Utilities::Random(0, areaSize);
+		}
+		std::vector<POSITION> centers(nQueries);
+		std::vector<double> radii(nQueries);
+		for(int q = 0; q < nQueries; q++) {
+			centers[q] = GetRandomPosition(areaSize);
+			radii[q] = Utilities::Random(MIN_REQUEST_DISTANCE, MAX_REQUEST_DISTANCE);
+			if(q % 2 == 1) {
+				POSITION edge;
+				int i = (int) Utilities::Random(0, nPoints - 1);
+				edge.x = x[i];
+				edge.y = y[i];
+				radii[q] = PositionApplication::CalculateDistanceFromTo(edge, centers[q]);
+			}
+		}
+		std::vector<std::vector<int> > expected(nQueries);
+		double start = Utilities::GetWallClockTime();
+		for(int q = 0; q < nQueries; q++) {
+			for(int i = 0; i < nPoints; i++) {
+				POSITION point;
+				point.x = x[i];
+				point.y = y[i];
+				if(PositionApplication::CalculateDistanceFromTo(point, centers[q]) <= radii[q]) {
+					expected[q].push_back(i);
+				}
+			}
+		}
+		double referenceTime = Utilities::GetWallClockTime() - start;
+		std::cout << "radiusFilter points=" << nPoints << " distances=" << referenceTime * 1e9 / nQueries / nPoints << "ns";
+		std::vector<int> indices(nPoints);
+		for(int f = 0; f < nFilters; f++) {
+			bool match = true;
+			start = Utilities::GetWallClockTime();
+			for(int q = 0; q < nQueries; q++) {
+				int count = filters[f](&x[0], &y[0], nPoints, centers[q].x, centers[q].y, RadiusFilter::GetSquaredRadius(radii[q]), &indices[0]);
+				match = match && count == (int) expected[q].size() && std::equal(expected[q].begin(), expected[q].end(), indices.begin());
+			}
+			double time = Utilities::GetWallClockTime() - start;
+			std::cout << " " << names[f] << "=" << time * 1e9 / nQueries / nPoints << "ns"
+					<< (match ? "" : "(mismatch)");
+			passed = passed && match;
+		}
+		std::cout << " selected=" << instructionSet << std::endl;
+	}
+	return passed;
+}
+
+/*
+ * Every node notifies each one to two hello periods until it goes silent at a random time. The
+ * registry ages nodes with its wheel once per hello period, against a scan of every last seen time.
+ */
+bool Benchmark::RunExpiry() {
+	NS_LOG_FUNCTION_NOARGS();
+	const int nPeriods = 100;
+	const double expiry = 5 * HELLO_TIME * 1000;
+	const int sizes[] = {1000, 10000, 100000};
+	bool passed = true;
+	for(int s = 0; s < 3; s++) {
+		int nNodes = sizes[s];
+		NodeRegistry registry;
+		registry.SetSpatialIndex(false);
+		registry.SetExpiry(expiry);
+		std::map<uint, double> lastSeen;
+		std::vector<double> silentFrom(nNodes);
+		std::vector<double> nextNotification(nNodes);
+		std::list<std::string> services;
+		for(int i = 0; i < nNodes; i++) {
+			silentFrom[i] = Utilities::Random(0, nPeriods * HELLO_TIME * 1000);
+			nextNotification[i] = Utilities::Random(0, HELLO_TIME * 1000);
+		}
+		double wheelTime = 0;
+		double scanTime = 0;
+		uint64_t scanEvictions = 0;
+		for(int p = 1; p <= nPeriods; p++) {
+			double now = p * HELLO_TIME * 1000;
+			for(int i = 0; i < nNodes; i++) {
+				while(nextNotification[i] <= now && nextNotification[i] < silentFrom[i]) {
+					POSITION position = GetRandomPosition(MAX_DISTANCE);
+					registry.Update(i, position, services, nextNotification[i]);
+					lastSeen[i] = nextNotification[i];
+					nextNotification[i] += Utilities::Random(1, 2) * HELLO_TIME * 1000;
+				}
+			}
+			double start = Utilities::GetWallClockTime();
+			registry.Expire(now);
+			wheelTime += Utilities::GetWallClockTime() - start;
+			start = Utilities::GetWallClockTime();
+			for(std::map<uint, double>::iterator i = lastSeen.begin(); i != lastSeen.end();) {
+				if(i->second + expiry <= now) {
+					lastSeen.erase(i++);
+					scanEvictions++;
+				} else {
+					i++;
+				}
+			}
+			scanTime += Utilities::GetWallClockTime() - start;
+		}
+		registry.Publish();
+		int ticket;
+		const REGISTRY_SNAPSHOT *snapshot = registry.Acquire(ticket);
+		bool match = registry.GetEvictions() == scanEvictions && snapshot->nodes.GetSize() == (int) lastSeen.size();
+		for(std::map<uint, double>::iterator i = lastSeen.begin(); match && i != lastSeen.end(); i++) {
+			match = snapshot->nodes.Find(i->first) >= 0;
+		}
+		registry.Release(ticket);
+		std::cout << "expiry nodes=" << nNodes << " evictions=" << scanEvictions
+				<< " scan=" << scanTime * 1e6 / nPeriods << "us/period"
+				<< " wheel=" << wheelTime * 1e6 / nPeriods << "us/period"
+				<< " speedup=" << scanTime / wheelTime << "x"
+				<< " match=" << (match ? "yes" : "no") << std::endl;
+		passed = passed && match;
+	}
+	return passed;
+}
+
+/*
+ * Requests cover most of the area, so nearly every node is in range. Between rounds a tenth of the
+ * nodes change services, a few of them to services that can not be packed, so the posting lists
+ * are checked against the full scan as they are updated.
+ */
+bool Benchmark::RunServiceIndex() {
+	NS_LOG_FUNCTION_NOARGS();
+	const int nRounds = 5;
+	const int nRequests = 40;
+	const int sizes[] = {10000, 100000};
+	bool passed = true;
+	for(int s = 0; s < 2; s++) {
+		int nNodes = sizes[s];
+		CentralMatcher matcher;
+		matcher.SetServiceIndex(true);
+		std::vector<SearchRequestHeader> requests(nRequests * nRounds);
+		for(uint i = 0; i < requests.size(); i++) {
+			requests[i].SetRequestPosition(GetRandomPosition(MAX_DISTANCE));
+			requests[i].SetMaxDistanceAllowed(Utilities::Random(MIN_REQUEST_DISTANCE, MAX_REQUEST_DISTANCE));
+			requests[i].SetRequestedService(OntologyApplication::GetRandomService());
+		}
+		for(int nSchedule = 1; nSchedule <= 5; nSchedule += 2) {
+			matcher.MAX_SCHEDULE_SIZE = nSchedule;
+			double scanTime = 0;
+			double indexTime = 0;
+			bool match = true;
+			for(int r = 0; r < nRounds; r++) {
+				for(int i = 1; i <= nNodes; i++) {
+					if(r > 0 && Utilities::Random(0, 1) >= 0.1) {
+						continue;
+					}
+					std::list<std::string> offeredServices;
+					offeredServices.push_back(OntologyApplication::GetRandomService());
+					offeredServices.push_back(OntologyApplication::GetRandomService());
+					if(Utilities::Random(0, 1) < 0.01) {
+						offeredServices.push_back("/not/in/the/catalog");
+					}
+					matcher.registry.Update(i, GetRandomPosition(MAX_DISTANCE), offeredServices, 0);
+				}
+				matcher.registry.Publish();
+				int ticket;
+				const REGISTRY_SNAPSHOT *snapshot = matcher.registry.Acquire(ticket);
+				for(int q = r * nRequests; q < (r + 1) * nRequests; q++) {
+					std::vector<int> nodes = matcher.FilterNodesByDistance(snapshot, requests[q]);
+					matcher.USE_SERVICE_INDEX = false;
+					double start = Utilities::GetWallClockTime();
+					std::list<uint> expected = matcher.GetScheduleNodesSinglePass(snapshot, nodes, requests[q]);
+					scanTime += Utilities::GetWallClockTime() - start;
+					matcher.USE_SERVICE_INDEX = true;
+					start = Utilities::GetWallClockTime();
+					match = match && expected == matcher.GetScheduleNodesSinglePass(snapshot, nodes, requests[q]);
+					indexTime += Utilities::GetWallClockTime() - start;
+				}
+				matcher.registry.Release(ticket);
+			}
+			std::cout << "serviceIndex nodes=" << nNodes << " nSchedule=" << nSchedule
+					<< " scan=" << scanTime * 1e6 / nRequests / nRounds << "us/request"
+					<< " index=" << indexTime * 1e6 / nRequests / nRounds << "us/request"
+					<< " speedup=" << scanTime / indexTime << "x"
+					<< " match=" << (match ? "yes" : "no") << std::endl;
+			passed = passed && match;
+		}
+	}
+	return passed;
+}
\ No newline at end of file
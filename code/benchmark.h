@@ -0,0 +1,39 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <string>
+#include <vector>
+
+#include "definitions.h"
+
+class Benchmark {
+
+	public:
+		static bool Run(std::string name, std::vector<int> sizes);
+
+	private:
+		static POSITION GetRandomPosition(double areaSize);
+
+		static bool RunSpatialIndex();
+		static bool RunScheduleSelection();
+		static bool RunNotificationMemory();
+		static bool RunWireFormat();
+		static bool RunRandomDraw();
+		static bool RunSessionTable();
+		static bool RunServicePaths();
+		static bool RunNodeTable();
+		static bool RunRadiusFilter();
+		static bool RunExpiry();
+		static bool RunServiceIndex();
+
+		static int OpenCacheMissCounter();
+		static long ReadCounter(int counter);
+
+		static int remainingEvents;
+		static double RunJitterEvents(int nEvents, bool cached);
+		static void JitterEvent(bool cached);
+
+		template <class T> static T RoundTrip(T header);
+};
+
+#endif
\ No newline at end of file
@@ -1,8 +1,4 @@
 #include "central-application.h"
-#include "position-application.h"
-#include "ontology-application.h"
-
-#include <limits>
 
 #include "utilities.h"
 #include "type-header.h"
@@ -20,7 +16,37 @@ TypeId CentralApplication::GetTypeId() {
  						"Max number of nodes in a schedule.",
  						IntegerValue(3),
  						MakeIntegerAccessor(&CentralApplication::MAX_SCHEDULE_SIZE),
- 						MakeIntegerChecker<int>());
+ 						MakeIntegerChecker<int>())
+		.AddAttribute("spatialIndex",
+						"Use a grid index instead of a linear scan to find the nodes in the area of interest.",
+						BooleanValue(true),
+						MakeBooleanAccessor(&CentralApplication::USE_SPATIAL_INDEX),
+						MakeBooleanChecker())
+		.AddAttribute("topKSelection",
+						"Score every candidate once and keep the best nSchedule in a bounded heap.",
+						BooleanValue(true),
+						MakeBooleanAccessor(&CentralApplication::USE_TOP_K_SELECTION),
+						MakeBooleanChecker())
+		.AddAttribute("serviceIndex",
+						"Keep posting lists of the nodes under each service and stop the top-k selection once no other node can make the schedule.",
+						BooleanValue(false),
+						MakeBooleanAccessor(&CentralApplication::USE_SERVICE_INDEX),
+						MakeBooleanChecker())
+		.AddAttribute("predictionMargin",
+						"Meters added to the request radius when matching predicted positions, negative to narrow it.",
+						DoubleValue(0),
+						MakeDoubleAccessor(&CentralApplication::PREDICTION_MARGIN),
+						MakeDoubleChecker<double>())
+		.AddAttribute("expiry",
+						"Number of hello periods a node may go unheard before it is evicted, 0 to never evict.",
+						DoubleValue(0),
+						MakeDoubleAccessor(&CentralApplication::EXPIRY),
+						MakeDoubleChecker<double>(0))
+		.AddAttribute("maxSpeed",
+						"Highest speed in m/s a node may report, faster velocities are clamped to it.",
+						DoubleValue(MAX_NODE_SPEED),
+						MakeDoubleAccessor(&CentralApplication::MAX_SPEED),
+						MakeDoubleChecker<double>(0));
 	return typeId;
 }
 
@@ -34,7 +60,13 @@ CentralApplication::~CentralApplication() {
 
 void CentralApplication::DoInitialize() {
 	NS_LOG_FUNCTION(this);
-	pthread_mutex_init(&mutex, NULL);
+	matcher.SetScheduleSize(MAX_SCHEDULE_SIZE);
+	matcher.SetSpatialIndex(USE_SPATIAL_INDEX);
+	matcher.SetTopKSelection(USE_TOP_K_SELECTION);
+	matcher.SetServiceIndex(USE_SERVICE_INDEX);
+	matcher.SetPredictionMargin(PREDICTION_MARGIN);
+	matcher.SetExpiryTime(EXPIRY * HELLO_TIME * 1000);
+	matcher.SetMaxSpeed(MAX_SPEED);
 	socket = Socket::CreateSocket(GetNode(), UdpSocketFactory::GetTypeId());
 	socket->SetAllowBroadcast(false);
 	InetSocketAddress local = InetSocketAddress(GetNode()->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal(), SEARCH_PORT);
@@ -47,13 +79,15 @@ void CentralApplication::DoDispose() {
 	if(socket != NULL) {
 		socket->Close();
 	}
-	pthread_mutex_destroy(&mutex);
 	Application::DoDispose();
 }
 
 void CentralApplication::StartApplication() {
 	NS_LOG_FUNCTION(this);
 	socket->SetRecvCallback(MakeCallback(&CentralApplication::ReceiveMessage, this));
+	if(EXPIRY > 0) {
+		expiryTimer = Simulator::Schedule(Seconds(HELLO_TIME), &CentralApplication::ExpireNodes, this);
+	}
 }
 
 void CentralApplication::StopApplication() {
@@ -61,6 +95,8 @@ void CentralApplication::StopApplication() {
 	if(socket != NULL) {
 		socket->SetRecvCallback(MakeNullCallback<void, Ptr<Socket> >());
 	}
+	Simulator::Cancel(expiryTimer);
+	NS_LOG_INFO(GetNode()->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal() << " -> Evicted " << matcher.GetEvictions() << " stale nodes");
 }
 
 void CentralApplication::ReceiveMessage(Ptr<Socket> socket) {
@@ -77,6 +113,9 @@ void CentralApplication::ReceiveMessage(Ptr<Socket> socket) {
 		case STRATOS_SEARCH_NOTIFICATION:
 			ReceiveNotification(packet);
 			break;
+		case STRATOS_SEARCH_NOTIFICATION_DELTA:
+			ReceiveNotificationDelta(packet);
+			break;
 		case STRATOS_SEARCH_REQUEST:
 			ReceiveRequest(packet);
 			break;
@@ -98,78 +137,32 @@ void CentralApplication::ReceiveRequest(Ptr<Packet> packet) {
 	SearchRequestHeader requestHeader;
 	packet->RemoveHeader(requestHeader);
 	NS_LOG_DEBUG(GetNode()->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal() << " -> Received request: " << requestHeader);
-	std::list<uint> nodes = FilterNodesByDistance(requestHeader);
-	if(nodes.size() <= 0) {
-		NS_LOG_DEBUG(GetNode()->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal() << " -> There are no nodes in the area of interest, sending error");
-		CreateAndSendError(requestHeader);
-		return;
-	}
-	std::list<uint> scheduleNodes = GetScheduleNodes(nodes, requestHeader);
-	if(!scheduleNodes.empty()) {
-		CreateAndSendResponse(scheduleNodes, requestHeader);
+	//Every notification dirties the registry, so it is only copied into a snapshot when a request needs it
+	matcher.Publish();
+	SearchScheduleHeader scheduleHeader;
+	if(matcher.CreateSchedule(requestHeader, scheduleHeader)) {
+		SendResponse(scheduleHeader);
 	} else {
 		CreateAndSendError(requestHeader);
 	}
 }
 
-std::list<uint> CentralApplication::FilterNodesByDistance(SearchRequestHeader request) {
-	NS_LOG_FUNCTION(this << request);
-	std::list<uint> nodes;
-	POSITION nodePosition;
-	POSITION requestPosition = request.GetRequestPosition();
-	double requestDistance = request.GetMaxDistanceAllowed();
-	pthread_mutex_lock(&mutex);
-	for(std::map<uint, POSITION>::iterator i = positions.begin(); i != positions.end(); i++) {
-		if(i->first != request.GetRequestAddress().Get()) {
-			nodePosition = i->second;
-			double distance = PositionApplication::CalculateDistanceFromTo(nodePosition, requestPosition);
-			if(distance <= requestDistance) {
-				nodes.push_back(i->first);
-			}
-		}
-	}
-	pthread_mutex_unlock(&mutex);
-	NS_LOG_DEBUG(GetNode()->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal() << " -> There are " << nodes.size() << " nodes in the area of interest");
-	return nodes;
-}
-
-std::list<uint> CentralApplication::GetScheduleNodes(std::list<uint> nodes, SearchRequestHeader request) {
-	NS_LOG_FUNCTION(this << &nodes << request);
-	std::list<uint> bestNodes;
-	OFFERED_SERVICE bestOfferedService;
-	std::list<std::string> offeredServices;
-	std::string requestedService = request.GetRequestedService();
-	while(!nodes.empty() && bestNodes.size() < MAX_SCHEDULE_SIZE) {
-		std::list<uint>::iterator bestNode = nodes.begin();
-		int minSemanticDistance = std::numeric_limits<int>::max();
-		NS_LOG_DEBUG(GetNode()->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal() << " -> Searching best node to provide service " << requestedService);
-		for(std::list<uint>::iterator i = nodes.begin(); i != nodes.end(); i++) {
-			pthread_mutex_lock(&mutex);
-			offeredServices = services[*i];
-			pthread_mutex_unlock(&mutex);
-			bestOfferedService = OntologyApplication::GetBestOfferedService(requestedService, offeredServices);
-			if(bestOfferedService.semanticDistance < minSemanticDistance) {
-				bestNode = i;
-				minSemanticDistance = bestOfferedService.semanticDistance;
-			}
-		}
-		NS_LOG_DEBUG(GetNode()->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal() << " -> Best node to provide service " << requestedService << " is " << *bestNode << " providing service " << bestOfferedService.service << " with semantic distance " << minSemanticDistance);
-		bestNodes.push_back(*bestNode);
-		nodes.erase(bestNode);
-	}
-	return bestNodes;
-}
-
 void CentralApplication::ReceiveNotification(Ptr<Packet> packet) {
 	NS_LOG_FUNCTION(this << packet);
 	SearchNotificationHeader notificationHeader;
 	packet->RemoveHeader(notificationHeader);
 	NS_LOG_DEBUG(GetNode()->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal() << " -> Received notification: " << notificationHeader);
-	uint node = notificationHeader.GetNodeAddress().Get();
-	pthread_mutex_lock(&mutex);
-	services[node] = notificationHeader.GetOfferedServices();
-	positions[node] = notificationHeader.GetCurrentPosition();
-	pthread_mutex_unlock(&mutex);
+	matcher.UpdateNode(notificationHeader, Utilities::GetCurrentRawDateTime());
+}
+
+void CentralApplication::ReceiveNotificationDelta(Ptr<Packet> packet) {
+	NS_LOG_FUNCTION(this << packet);
+	SearchNotificationDeltaHeader deltaHeader;
+	packet->RemoveHeader(deltaHeader);
+	NS_LOG_DEBUG(GetNode()->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal() << " -> Received notification delta: " << deltaHeader);
+	if(!matcher.UpdateNode(deltaHeader, Utilities::GetCurrentRawDateTime())) {
+		NS_LOG_DEBUG(GetNode()->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal() << " -> Notification delta from unknown node waits for its keepalive");
+	}
 }
 
 void CentralApplication::SendError(SearchErrorHeader errorHeader) {
@@ -184,16 +177,7 @@ void CentralApplication::SendError(SearchErrorHeader errorHeader) {
 
 void CentralApplication::CreateAndSendError(SearchRequestHeader request) {
 	NS_LOG_FUNCTION(this << request);
-	SendError(CreateError(request));
-}
-
-SearchErrorHeader CentralApplication::CreateError(SearchRequestHeader request) {
-	NS_LOG_FUNCTION(this << request);
-	SearchErrorHeader error;
-	error.SetRequestAddress(request.GetRequestAddress());
-	error.SetRequestTimestamp(request.GetRequestTimestamp());
-	NS_LOG_DEBUG(GetNode()->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal() << " -> Error created: " << error);
-	return error;
+	SendError(CentralMatcher::CreateError(request));
 }
 
 void CentralApplication::SendResponse(SearchScheduleHeader scheduleHeader) {
@@ -206,40 +190,21 @@ void CentralApplication::SendResponse(SearchScheduleHeader scheduleHeader) {
 	Simulator::Schedule(Seconds(Utilities::GetJitter()), &CentralApplication::SendUnicastMessage, this, packet, scheduleHeader.GetRequestAddress().Get());
 }
 
-SearchResponseHeader CentralApplication::CreateResponse(uint node, SearchRequestHeader request) {
-	NS_LOG_FUNCTION(this << node << request);
-	pthread_mutex_lock(&mutex);
-	POSITION nodePosition = positions[node];
-	std::list<std::string> nodeServices = services[node];
-	pthread_mutex_unlock(&mutex);
-	POSITION requesterPosition = request.GetRequestPosition();
-	SearchResponseHeader response;
-	response.SetResponseAddress(Ipv4Address(node));
-	response.SetRequestAddress(request.GetRequestAddress());
-	response.SetRequestTimestamp(request.GetRequestTimestamp());
-	response.SetDistance(PositionApplication::CalculateDistanceFromTo(requesterPosition, nodePosition));
-	response.SetOfferedService(OntologyApplication::GetBestOfferedService(request.GetRequestedService(), nodeServices));
-	NS_LOG_DEBUG(GetNode()->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal() << " -> Response created: " << response);
-	return response;
-}
-
-void CentralApplication::CreateAndSendResponse(std::list<uint> scheduleNodes, SearchRequestHeader request) {
-	NS_LOG_FUNCTION(this << &scheduleNodes << request);
-	SendResponse(CreateResponse(scheduleNodes, request));
-}
-
-SearchScheduleHeader CentralApplication::CreateResponse(std::list<uint> scheduleNodes, SearchRequestHeader request) {
-	NS_LOG_FUNCTION(this << &scheduleNodes << request);
-	SearchScheduleHeader scheduleResponse;
-	scheduleResponse.SetRequestAddress(request.GetRequestAddress());
-	scheduleResponse.SetRequestTimestamp(request.GetRequestTimestamp());
-	std::list<SearchResponseHeader> schedule;
-	for(std::list<uint>::iterator i = scheduleNodes.begin(); i != scheduleNodes.end(); i++) {
-		schedule.push_back(CreateResponse((*i), request));
+/*
+ * The registry is aged once per hello period, which is also the granularity of its expiry wheel.
+ * Requests in between already leave out the nodes that expired since, and publish the evictions.
+ */
+void CentralApplication::ExpireNodes() {
+	NS_LOG_FUNCTION(this);
+	int nEvicted = matcher.ExpireNodes(Utilities::GetCurrentRawDateTime());
+	if(nEvicted > 0) {
+		NS_LOG_DEBUG(GetNode()->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal() << " -> Evicted " << nEvicted << " stale nodes");
 	}
-	scheduleResponse.SetSchedule(schedule);
-	NS_LOG_DEBUG(GetNode()->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal() << " -> Schedule response created: " << scheduleResponse);
-	return scheduleResponse;
+	expiryTimer = Simulator::Schedule(Seconds(HELLO_TIME), &CentralApplication::ExpireNodes, this);
+}
+
+uint64_t CentralApplication::GetEvictions() const {
+	return matcher.GetEvictions();
 }
 
 CentralHelper::CentralHelper() {
@@ -3,16 +3,11 @@
 
 #include "ns3/internet-module.h"
 
-#include <map>
-#include <pthread.h>
+#include <list>
 
 #include "definitions.h"
+#include "central-matcher.h"
 #include "application-helper.h"
-#include "search-error-header.h"
-#include "search-request-header.h"
-#include "search-response-header.h"
-#include "search-schedule-header.h"
-#include "search-notification-header.h"
 
 using namespace ns3;
 
@@ -34,29 +29,34 @@ class CentralApplication : public Application {
 
 	private:
 		int MAX_SCHEDULE_SIZE;
-		pthread_mutex_t mutex;
-		std::map<uint, POSITION> positions;
-		std::map<uint, std::list<std::string> > services;
+		bool USE_SPATIAL_INDEX;
+		bool USE_TOP_K_SELECTION;
+		bool USE_SERVICE_INDEX;
+		double PREDICTION_MARGIN;
+		double EXPIRY;
+		double MAX_SPEED;
+		CentralMatcher matcher;
 
 		Ptr<Socket> socket;
+		EventId expiryTimer;
 
 		void ReceiveMessage(Ptr<Socket> socket);
 		void SendUnicastMessage(Ptr<Packet> packet, uint destinationAddress);
 
 		void ReceiveRequest(Ptr<Packet> packet);
-		std::list<uint> FilterNodesByDistance(SearchRequestHeader request);
-		std::list<uint> GetScheduleNodes(std::list<uint> nodes, SearchRequestHeader request);
 
 		void ReceiveNotification(Ptr<Packet> packet);
+		void ReceiveNotificationDelta(Ptr<Packet> packet);
 
 		void SendError(SearchErrorHeader errorHeader);
 		void CreateAndSendError(SearchRequestHeader request);
-		SearchErrorHeader CreateError(SearchRequestHeader request);
 
 		void SendResponse(SearchScheduleHeader scheduleHeader);
-		SearchResponseHeader CreateResponse(uint node, SearchRequestHeader request);
-		void CreateAndSendResponse(std::list<uint> scheduleNodes, SearchRequestHeader request);
-		SearchScheduleHeader CreateResponse(std::list<uint> scheduleNodes, SearchRequestHeader request);
+
+		void ExpireNodes();
+
+	public:
+		uint64_t GetEvictions() const;
 };
 
 class CentralHelper : public ApplicationHelper {
@@ -0,0 +1,466 @@
+#include "central-matcher.h"
+
+#include "ns3/core-module.h"
+
+#include <limits>
+#include <vector>
+#include <algorithm>
+
+#include "service-path.h"
+#include "position-application.h"
+#include "ontology-application.h"
+
+NS_LOG_COMPONENT_DEFINE("CentralMatcher");
+
+CentralMatcher::CentralMatcher() {
+	NS_LOG_FUNCTION(this);
+	MAX_SCHEDULE_SIZE = 3;
+	USE_SPATIAL_INDEX = true;
+	USE_TOP_K_SELECTION = true;
+	USE_SERVICE_INDEX = false;
+	PREDICTION_MARGIN = 0;
+	EXPIRY_TIME = 0;
+}
+
+void CentralMatcher::SetScheduleSize(int scheduleSize) {
+	NS_LOG_FUNCTION(this << scheduleSize);
+	MAX_SCHEDULE_SIZE = scheduleSize;
+}
+
+void CentralMatcher::SetSpatialIndex(bool spatialIndex) {
+	NS_LOG_FUNCTION(this << spatialIndex);
+	USE_SPATIAL_INDEX = spatialIndex;
+	registry.SetSpatialIndex(spatialIndex);
+}
+
+void CentralMatcher::SetTopKSelection(bool topKSelection) {
+	NS_LOG_FUNCTION(this << topKSelection);
+	USE_TOP_K_SELECTION = topKSelection;
+}
+
+void CentralMatcher::SetServiceIndex(bool serviceIndex) {
+	NS_LOG_FUNCTION(this << serviceIndex);
+	USE_SERVICE_INDEX = serviceIndex;
+	registry.SetServiceIndex(serviceIndex);
+}
+
+/*
+ * Requests can only be checked against the expiry when their timestamps are on the clock nodes
+ * were last seen on. Otherwise stale nodes are only left out once the registry evicts them.
+ */
+void CentralMatcher::SetExpiryTime(double expiryTime, bool checkRequests) {
+	NS_LOG_FUNCTION(this << expiryTime << checkRequests);
+	EXPIRY_TIME = checkRequests ? expiryTime : 0;
+	registry.SetExpiry(expiryTime);
+}
+
+double CentralMatcher::GetExpiryTime() const {
+	return registry.GetExpiry();
+}
+
+void CentralMatcher::SetMaxSpeed(double maxSpeed) {
+	NS_LOG_FUNCTION(this << maxSpeed);
+	registry.SetMaxSpeed(maxSpeed);
+}
+
+void CentralMatcher::SetPredictionMargin(double predictionMargin) {
+	NS_LOG_FUNCTION(this << predictionMargin);
+	PREDICTION_MARGIN = predictionMargin;
+}
+
+/*
+ * The timestamp is when the notification arrived, in milliseconds, and becomes the last time the node
+ * was seen. Notifications only carry their own timestamp along with a velocity.
+ */
+void CentralMatcher::UpdateNode(SearchNotificationHeader notification, double timestamp) {
+	NS_LOG_FUNCTION(this << notification << timestamp);
+	registry.Update(notification.GetNodeAddress().Get(), notification.GetCurrentPosition(), notification.GetOfferedServiceList(), timestamp);
+	if(notification.HasVelocity()) {
+		MOTION motion;
+		motion.velocity = notification.GetVelocity();
+		motion.timestamp = notification.GetNotificationTimestamp();
+		registry.UpdateMotion(notification.GetNodeAddress().Get(), motion);
+	}
+}
+
+bool CentralMatcher::UpdateNode(SearchNotificationDeltaHeader delta, double timestamp) {
+	NS_LOG_FUNCTION(this << delta << timestamp);
+	uint node = delta.GetNodeAddress().Get();
+	bool known = true;
+	if(delta.HasPosition() && delta.HasOfferedServices()) {
+		registry.Update(node, delta.GetCurrentPosition(), delta.GetOfferedServiceList(), timestamp);
+	} else {
+		if(delta.HasPosition()) {
+			known = registry.UpdatePosition(node, delta.GetCurrentPosition(), timestamp);
+		}
+		if(delta.HasOfferedServices()) {
+			known = registry.UpdateServices(node, delta.GetOfferedServiceList(), timestamp) && known;
+		}
+	}
+	if(delta.HasVelocity()) {
+		MOTION motion;
+		motion.velocity = delta.GetVelocity();
+		motion.timestamp = delta.GetNotificationTimestamp();
+		known = registry.UpdateMotion(node, motion) && known;
+	}
+	return known;
+}
+
+/*
+ * Evicts the nodes last seen more than the expiry time before now, both in milliseconds. The evictions
+ * are staged and only visible to requests after the next Publish.
+ */
+int CentralMatcher::ExpireNodes(double now) {
+	NS_LOG_FUNCTION(this << now);
+	return registry.Expire(now);
+}
+
+uint64_t CentralMatcher::GetEvictions() const {
+	return registry.GetEvictions();
+}
+
+void CentralMatcher::Publish() {
+	NS_LOG_FUNCTION(this);
+	registry.Publish();
+}
+
+bool CentralMatcher::CreateSchedule(SearchRequestHeader request, SearchScheduleHeader &scheduleHeader) {
+	NS_LOG_FUNCTION(this << request);
+	int ticket;
+	const REGISTRY_SNAPSHOT *snapshot = registry.Acquire(ticket);
+	NS_LOG_DEBUG("Processing request against registry version " << snapshot->version);
+	std::vector<int> nodes = FilterNodesByDistance(snapshot, request);
+	if(nodes.empty()) {
+		NS_LOG_DEBUG("There are no nodes in the area of interest");
+		registry.Release(ticket);
+		return false;
+	}
+	std::list<uint> scheduleNodes = GetScheduleNodes(snapshot, nodes, request);
+	if(!scheduleNodes.empty()) {
+		scheduleHeader = CreateResponse(snapshot, scheduleNodes, request);
+	}
+	registry.Release(ticket);
+	return !scheduleNodes.empty();
+}
+
+SearchErrorHeader CentralMatcher::CreateError(SearchRequestHeader request) {
+	NS_LOG_FUNCTION(request);
+	SearchErrorHeader error;
+	error.SetRequestAddress(request.GetRequestAddress());
+	error.SetRequestTimestamp(request.GetRequestTimestamp());
+	NS_LOG_DEBUG("Error created: " << error);
+	return error;
+}
+
+/*
+ * Returns the slots of the nodes in range. Nodes that reported a velocity are extrapolated to the
+ * request time, up to MAX_PREDICTION_TIME. The grid still holds reported positions, so it is queried
+ * with the radius widened by the farthest any node can have moved since, and the predicted positions
+ * are checked afterwards. Without the grid the node table is scanned, in the order nodes registered.
+ * Nodes past their expiry at the request time are left out even if the registry has not evicted them yet.
+ */
+std::vector<int> CentralMatcher::FilterNodesByDistance(const REGISTRY_SNAPSHOT *snapshot, SearchRequestHeader request) {
+	NS_LOG_FUNCTION(this << snapshot << request);
+	std::vector<int> nodes;
+	POSITION requestPosition = request.GetRequestPosition();
+	double requestDistance = request.GetMaxDistanceAllowed() + PREDICTION_MARGIN;
+	if(requestDistance < 0) {
+		return nodes;
+	}
+	const NodeTable &table = snapshot->nodes;
+	if(USE_SPATIAL_INDEX) {
+		double maxDisplacement = table.HasMotions() ? snapshot->maxSpeed * MAX_PREDICTION_TIME : 0;
+		std::list<uint> addresses = snapshot->grid.GetNodesInRange(requestPosition, requestDistance + maxDisplacement);
+		nodes.reserve(addresses.size());
+		for(std::list<uint>::iterator i = addresses.begin(); i != addresses.end(); i++) {
+			int slot = table.Find(*i);
+			if(maxDisplacement > 0 && PositionApplication::CalculateDistanceFromTo(table.PredictPosition(slot, request.GetRequestTimestamp()), requestPosition) > requestDistance) {
+				continue;
+			}
+			nodes.push_back(slot);
+		}
+	} else {
+		table.FilterInRange(requestPosition, requestDistance, request.GetRequestTimestamp(), nodes);
+	}
+	int requester = table.Find(request.GetRequestAddress().Get());
+	if(requester >= 0) {
+		nodes.erase(std::remove(nodes.begin(), nodes.end(), requester), nodes.end());
+	}
+	if(EXPIRY_TIME > 0) {
+		double deadline = request.GetRequestTimestamp() - EXPIRY_TIME;
+		uint nFresh = 0;
+		for(uint i = 0; i < nodes.size(); i++) {
+			if(table.GetLastSeen(nodes[i]) > deadline) {
+				nodes[nFresh++] = nodes[i];
+			}
+		}
+		nodes.resize(nFresh);
+	}
+	NS_LOG_DEBUG("There are " << nodes.size() << " nodes in the area of interest");
+	return nodes;
+}
+
+std::list<uint> CentralMatcher::GetScheduleNodes(const REGISTRY_SNAPSHOT *snapshot, const std::vector<int> &nodes, SearchRequestHeader request) {
+	NS_LOG_FUNCTION(this << snapshot << &nodes << request);
+	if(USE_TOP_K_SELECTION) {
+		return GetScheduleNodesSinglePass(snapshot, nodes, request);
+	}
+	return GetScheduleNodesIteratively(snapshot, nodes, request);
+}
+
+std::list<uint> CentralMatcher::GetScheduleNodesSinglePass(const REGISTRY_SNAPSHOT *snapshot, const std::vector<int> &nodes, SearchRequestHeader request) {
+	NS_LOG_FUNCTION(this << snapshot << &nodes << request);
+	std::list<uint> bestNodes;
+	if(MAX_SCHEDULE_SIZE <= 0) {
+		return bestNodes;
+	}
+	//Heap ordered by IsBetterCandidate, so its front is the worst of the best nodes found so far
+	std::vector<SCHEDULE_CANDIDATE> heap;
+	heap.reserve(MAX_SCHEDULE_SIZE);
+	NS_LOG_DEBUG("Searching best " << MAX_SCHEDULE_SIZE << " nodes to provide service " << request.GetRequestedService());
+	if(USE_SERVICE_INDEX) {
+		AddCandidatesByService(snapshot, nodes, request, heap);
+	} else {
+		AddCandidates(snapshot, nodes, request, heap);
+	}
+	std::sort_heap(heap.begin(), heap.end(), IsBetterCandidate);
+	for(std::vector<SCHEDULE_CANDIDATE>::iterator i = heap.begin(); i != heap.end(); i++) {
+		NS_LOG_DEBUG("Node " << i->address << " provides service " << request.GetRequestedService() << " with semantic distance " << i->semanticDistance);
+		bestNodes.push_back(i->address);
+	}
+	return bestNodes;
+}
+
+void CentralMatcher::AddCandidates(const REGISTRY_SNAPSHOT *snapshot, const std::vector<int> &nodes, SearchRequestHeader request, std::vector<SCHEDULE_CANDIDATE> &heap) {
+	NS_LOG_FUNCTION(this << snapshot << &nodes << request << &heap);
+	SCHEDULE_CANDIDATE candidate;
+	std::vector<int> semanticDistances = GetSemanticDistances(snapshot, nodes, request);
+	std::vector<int>::iterator semanticDistance = semanticDistances.begin();
+	for(std::vector<int>::const_iterator i = nodes.begin(); i != nodes.end(); i++, semanticDistance++) {
+		candidate.address = snapshot->nodes.GetAddress(*i);
+		candidate.semanticDistance = *semanticDistance;
+		PushCandidate(heap, candidate);
+	}
+}
+
+/*
+ * Scores the nodes in range in increasing order of their best possible semantic distance, using the
+ * posting lists of the requested service of depth D. Nodes offering the service or one of its
+ * ancestors are at distance 0, and as ties are broken by address and posting lists are sorted by it,
+ * only the first MAX_SCHEDULE_SIZE in range of each of those lists can make the schedule. If there
+ * are fewer, every node at distance 0 has been found. Any other node is at least D - c away, c being
+ * the most levels one of its services shares with the requested one. So once the nodes under the
+ * prefix of depth c are scored, those left are at least D - c + 1 away, and the walk stops when the
+ * heap is full of nodes closer than that. Nodes with services that can not be packed are scored
+ * first, and the nodes left are all scored at once when a posting list is longer than them.
+ */
+void CentralMatcher::AddCandidatesByService(const REGISTRY_SNAPSHOT *snapshot, const std::vector<int> &nodes, SearchRequestHeader request, std::vector<SCHEDULE_CANDIDATE> &heap) {
+	NS_LOG_FUNCTION(this << snapshot << &nodes << request << &heap);
+	SERVICE_PATH requestedPath;
+	if(!ServicePath::Pack(request.GetRequestedService(), requestedPath)) {
+		AddCandidates(snapshot, nodes, request, heap);
+		return;
+	}
+	const ServiceIndex &index = snapshot->services;
+	//1 for the nodes in range not scored yet, 2 for those already scored
+	std::vector<char> candidates(snapshot->nodes.GetSize(), 0);
+	for(std::vector<int>::const_iterator i = nodes.begin(); i != nodes.end(); i++) {
+		candidates[*i] = 1;
+	}
+	int nLeft = nodes.size();
+	std::vector<int> found;
+	for(int depth = 0; depth <= requestedPath.depth; depth++) {
+		nLeft -= CollectProviders(snapshot, index.GetProviders(requestedPath, depth), MAX_SCHEDULE_SIZE, candidates, found);
+	}
+	SCHEDULE_CANDIDATE candidate;
+	candidate.semanticDistance = 0;
+	for(std::vector<int>::iterator i = found.begin(); i != found.end(); i++) {
+		candidate.address = snapshot->nodes.GetAddress(*i);
+		PushCandidate(heap, candidate);
+	}
+	found.clear();
+	nLeft -= CollectProviders(snapshot, index.GetUnpacked(), nodes.size(), candidates, found);
+	AddCandidates(snapshot, found, request, heap);
+	int minSemanticDistance = 1;
+	int depth = requestedPath.depth;
+	while(nLeft > 0 && !(heap.size() == (uint) MAX_SCHEDULE_SIZE && heap.front().semanticDistance < minSemanticDistance)) {
+		found.clear();
+		if(depth == 0 || index.GetProvidersUnder(requestedPath, depth).size() > (uint) nLeft) {
+			for(std::vector<int>::const_iterator i = nodes.begin(); i != nodes.end(); i++) {
+				if(candidates[*i] == 1) {
+					found.push_back(*i);
+				}
+			}
+			nLeft = 0;
+		} else {
+			nLeft -= CollectProviders(snapshot, index.GetProvidersUnder(requestedPath, depth), nodes.size(), candidates, found);
+			minSemanticDistance = requestedPath.depth - depth + 1;
+			depth--;
+		}
+		AddCandidates(snapshot, found, request, heap);
+	}
+	NS_LOG_DEBUG(nLeft << " of " << nodes.size() << " nodes in range were never scored");
+}
+
+/*
+ * Marks the providers that are in range and not scored yet, up to maxFound, and appends their slots to found.
+ */
+int CentralMatcher::CollectProviders(const REGISTRY_SNAPSHOT *snapshot, const std::set<uint> &providers, int maxFound, std::vector<char> &candidates, std::vector<int> &found) {
+	int nFound = 0;
+	for(std::set<uint>::const_iterator i = providers.begin(); i != providers.end() && nFound < maxFound; i++) {
+		int slot = snapshot->nodes.Find(*i);
+		if(slot >= 0 && candidates[slot] == 1) {
+			candidates[slot] = 2;
+			found.push_back(slot);
+			nFound++;
+		}
+	}
+	return nFound;
+}
+
+void CentralMatcher::PushCandidate(std::vector<SCHEDULE_CANDIDATE> &heap, SCHEDULE_CANDIDATE candidate) {
+	if(heap.size() < (uint) MAX_SCHEDULE_SIZE) {
+		heap.push_back(candidate);
+		std::push_heap(heap.begin(), heap.end(), IsBetterCandidate);
+	} else if(IsBetterCandidate(candidate, heap.front())) {
+		std::pop_heap(heap.begin(), heap.end(), IsBetterCandidate);
+		heap.back() = candidate;
+		std::push_heap(heap.begin(), heap.end(), IsBetterCandidate);
+	}
+}
+
+bool CentralMatcher::IsBetterCandidate(const SCHEDULE_CANDIDATE &candidate, const SCHEDULE_CANDIDATE &other) {
+	//Same criteria as SearchApplication::SelectBestResponse
+	if(candidate.semanticDistance != other.semanticDistance) {
+		return candidate.semanticDistance < other.semanticDistance;
+	}
+	return candidate.address < other.address;
+}
+
+/*
+ * Picks the closest node left until the schedule is full. The nodes are walked in address order, as
+ * neither the grid nor the node table return them that way, so ties go to the lowest address.
+ */
+std::list<uint> CentralMatcher::GetScheduleNodesIteratively(const REGISTRY_SNAPSHOT *snapshot, const std::vector<int> &candidates, SearchRequestHeader request) {
+	NS_LOG_FUNCTION(this << snapshot << &candidates << request);
+	std::list<uint> bestNodes;
+	std::vector<std::pair<uint, int> > byAddress;
+	byAddress.reserve(candidates.size());
+	for(std::vector<int>::const_iterator i = candidates.begin(); i != candidates.end(); i++) {
+		byAddress.push_back(std::make_pair(snapshot->nodes.GetAddress(*i), *i));
+	}
+	std::sort(byAddress.begin(), byAddress.end());
+	std::list<int> nodes;
+	for(std::vector<std::pair<uint, int> >::iterator i = byAddress.begin(); i != byAddress.end(); i++) {
+		nodes.push_back(i->second);
+	}
+	OFFERED_SERVICE bestOfferedService;
+	std::string requestedService = request.GetRequestedService();
+	int requestedServiceId = request.GetRequestedServiceId();
+	while(!nodes.empty() && bestNodes.size() < MAX_SCHEDULE_SIZE) {
+		std::list<int>::iterator bestNode = nodes.begin();
+		int minSemanticDistance = std::numeric_limits<int>::max();
+		NS_LOG_DEBUG("Searching best node to provide service " << requestedService);
+		for(std::list<int>::iterator i = nodes.begin(); i != nodes.end(); i++) {
+			bestOfferedService = GetBestOfferedService(snapshot, *i, requestedService, requestedServiceId);
+			if(bestOfferedService.semanticDistance < minSemanticDistance) {
+				bestNode = i;
+				minSemanticDistance = bestOfferedService.semanticDistance;
+			}
+		}
+		NS_LOG_DEBUG("Best node to provide service " << requestedService << " is " << snapshot->nodes.GetAddress(*bestNode) << " providing service " << bestOfferedService.service << " with semantic distance " << minSemanticDistance);
+		bestNodes.push_back(snapshot->nodes.GetAddress(*bestNode));
+		nodes.erase(bestNode);
+	}
+	return bestNodes;
+}
+
+/*
+ * Semantic distance of the best service of every node, in the order of nodes. When the requested
+ * service can be packed, the offered services of all the nodes are gathered in one array and scored
+ * in a single batch; nodes with services that can not be packed are scored one by one.
+ */
+std::vector<int> CentralMatcher::GetSemanticDistances(const REGISTRY_SNAPSHOT *snapshot, const std::vector<int> &nodes, SearchRequestHeader request) {
+	NS_LOG_FUNCTION(this << snapshot << &nodes << request);
+	std::string requestedService = request.GetRequestedService();
+	int requestedServiceId = request.GetRequestedServiceId();
+	std::vector<int> semanticDistances(nodes.size(), std::numeric_limits<int>::max());
+	SERVICE_PATH requestedPath;
+	if(!ServicePath::Pack(requestedService, requestedPath)) {
+		for(uint k = 0; k < nodes.size(); k++) {
+			semanticDistances[k] = GetBestOfferedService(snapshot, nodes[k], requestedService, requestedServiceId).semanticDistance;
+		}
+		return semanticDistances;
+	}
+	std::vector<SERVICE_PATH> offeredPaths;
+	//Offered services of node k are offeredPaths[ends[k - 1], ends[k]), or -1 when they were not packed
+	std::vector<int> ends(nodes.size());
+	offeredPaths.reserve(nodes.size());
+	int nPaths;
+	const SERVICE_PATH *paths;
+	for(uint k = 0; k < nodes.size(); k++) {
+		paths = snapshot->nodes.GetServicePaths(nodes[k], nPaths);
+		if(paths == NULL) {
+			ends[k] = -1;
+		} else {
+			offeredPaths.insert(offeredPaths.end(), paths, paths + nPaths);
+			ends[k] = offeredPaths.size();
+		}
+	}
+	std::vector<int> offeredDistances(offeredPaths.size());
+	if(!offeredPaths.empty()) {
+		ServicePath::SemanticDistances(requestedPath, &offeredPaths[0], offeredPaths.size(), &offeredDistances[0]);
+	}
+	int begin = 0;
+	for(uint k = 0; k < ends.size(); k++) {
+		if(ends[k] < 0) {
+			semanticDistances[k] = GetBestOfferedService(snapshot, nodes[k], requestedService, requestedServiceId).semanticDistance;
+			continue;
+		}
+		for(int j = begin; j < ends[k]; j++) {
+			semanticDistances[k] = std::min(semanticDistances[k], offeredDistances[j]);
+		}
+		begin = ends[k];
+	}
+	return semanticDistances;
+}
+
+OFFERED_SERVICE CentralMatcher::GetBestOfferedService(const REGISTRY_SNAPSHOT *snapshot, int slot, std::string requestedService, int requestedServiceId) {
+	NS_LOG_FUNCTION(this << snapshot << slot << requestedService << requestedServiceId);
+	int nIds;
+	const int *offeredServiceIds = snapshot->nodes.GetServiceIds(slot, nIds);
+	if(requestedServiceId != UNKNOWN_SERVICE && offeredServiceIds != NULL) {
+		return OntologyApplication::GetBestOfferedService(requestedServiceId, offeredServiceIds, nIds);
+	}
+	NS_LOG_DEBUG("Services of " << snapshot->nodes.GetAddress(slot) << " or " << requestedService << " are not in the catalog");
+	return OntologyApplication::GetBestOfferedService(requestedService, snapshot->nodes.GetServices(slot));
+}
+
+SearchResponseHeader CentralMatcher::CreateResponse(const REGISTRY_SNAPSHOT *snapshot, uint node, SearchRequestHeader request) {
+	NS_LOG_FUNCTION(this << snapshot << node << request);
+	int slot = snapshot->nodes.Find(node);
+	POSITION nodePosition = snapshot->nodes.PredictPosition(slot, request.GetRequestTimestamp());
+	POSITION requesterPosition = request.GetRequestPosition();
+	SearchResponseHeader response;
+	response.SetResponseAddress(Ipv4Address(node));
+	response.SetRequestAddress(request.GetRequestAddress());
+	response.SetRequestTimestamp(request.GetRequestTimestamp());
+	response.SetDistance(PositionApplication::CalculateDistanceFromTo(requesterPosition, nodePosition));
+	response.SetOfferedService(GetBestOfferedService(snapshot, slot, request.GetRequestedService(), request.GetRequestedServiceId()));
+	NS_LOG_DEBUG("Response created: " << response);
+	return response;
+}
+
+SearchScheduleHeader CentralMatcher::CreateResponse(const REGISTRY_SNAPSHOT *snapshot, std::list<uint> scheduleNodes, SearchRequestHeader request) {
+	NS_LOG_FUNCTION(this << snapshot << &scheduleNodes << request);
+	SearchScheduleHeader scheduleResponse;
+	scheduleResponse.SetRequestAddress(request.GetRequestAddress());
+	scheduleResponse.SetRequestTimestamp(request.GetRequestTimestamp());
+	std::list<SearchResponseHeader> schedule;
+	for(std::list<uint>::iterator i = scheduleNodes.begin(); i != scheduleNodes.end(); i++) {
+		schedule.push_back(CreateResponse(snapshot, (*i), request));
+	}
+	scheduleResponse.SetSchedule(schedule);
+	NS_LOG_DEBUG("Schedule response created: " << scheduleResponse);
+	return scheduleResponse;
+}
\ No newline at end of file
@@ -0,0 +1,77 @@
+#ifndef CENTRAL_MATCHER_H
+#define CENTRAL_MATCHER_H
+
+#include <set>
+#include <list>
+#include <vector>
+#include <string>
+
+#include "definitions.h"
+#include "node-registry.h"
+#include "search-error-header.h"
+#include "search-request-header.h"
+#include "search-response-header.h"
+#include "search-schedule-header.h"
+#include "search-notification-header.h"
+#include "search-notification-delta-header.h"
+
+using namespace ns3;
+
+/*
+ * Matching logic of the centralized approach, independent of how requests and
+ * notifications arrive. CreateSchedule only reads registry snapshots, so it can
+ * be called concurrently from several threads while notifications are staged.
+ */
+class CentralMatcher {
+
+	friend class Benchmark;
+	friend class KernelBenchmark;
+
+	public:
+		CentralMatcher();
+
+	private:
+		int MAX_SCHEDULE_SIZE;
+		bool USE_SPATIAL_INDEX;
+		bool USE_TOP_K_SELECTION;
+		bool USE_SERVICE_INDEX;
+		double PREDICTION_MARGIN;
+		double EXPIRY_TIME;
+		NodeRegistry registry;
+
+		std::vector<int> FilterNodesByDistance(const REGISTRY_SNAPSHOT *snapshot, SearchRequestHeader request);
+		std::list<uint> GetScheduleNodes(const REGISTRY_SNAPSHOT *snapshot, const std::vector<int> &nodes, SearchRequestHeader request);
+		std::list<uint> GetScheduleNodesSinglePass(const REGISTRY_SNAPSHOT *snapshot, const std::vector<int> &nodes, SearchRequestHeader request);
+		void AddCandidates(const REGISTRY_SNAPSHOT *snapshot, const std::vector<int> &nodes, SearchRequestHeader request, std::vector<SCHEDULE_CANDIDATE> &heap);
+		void AddCandidatesByService(const REGISTRY_SNAPSHOT *snapshot, const std::vector<int> &nodes, SearchRequestHeader request, std::vector<SCHEDULE_CANDIDATE> &heap);
+		int CollectProviders(const REGISTRY_SNAPSHOT *snapshot, const std::set<uint> &providers, int maxFound, std::vector<char> &candidates, std::vector<int> &found);
+		std::list<uint> GetScheduleNodesIteratively(const REGISTRY_SNAPSHOT *snapshot, const std::vector<int> &candidates, SearchRequestHeader request);
+		void PushCandidate(std::vector<SCHEDULE_CANDIDATE> &heap, SCHEDULE_CANDIDATE candidate);
+		static bool IsBetterCandidate(const SCHEDULE_CANDIDATE &candidate, const SCHEDULE_CANDIDATE &other);
+		std::vector<int> GetSemanticDistances(const REGISTRY_SNAPSHOT *snapshot, const std::vector<int> &nodes, SearchRequestHeader request);
+		OFFERED_SERVICE GetBestOfferedService(const REGISTRY_SNAPSHOT *snapshot, int slot, std::string requestedService, int requestedServiceId);
+
+		SearchResponseHeader CreateResponse(const REGISTRY_SNAPSHOT *snapshot, uint node, SearchRequestHeader request);
+		SearchScheduleHeader CreateResponse(const REGISTRY_SNAPSHOT *snapshot, std::list<uint> scheduleNodes, SearchRequestHeader request);
+
+	public:
+		void SetScheduleSize(int scheduleSize);
+		void SetSpatialIndex(bool spatialIndex);
+		void SetTopKSelection(bool topKSelection);
+		void SetServiceIndex(bool serviceIndex);
+		void SetPredictionMargin(double predictionMargin);
+		void SetExpiryTime(double expiryTime, bool checkRequests = true);
+		double GetExpiryTime() const;
+		void SetMaxSpeed(double maxSpeed);
+
+		void UpdateNode(SearchNotificationHeader notification, double timestamp);
+		bool UpdateNode(SearchNotificationDeltaHeader delta, double timestamp);
+		int ExpireNodes(double now);
+		uint64_t GetEvictions() const;
+		void Publish();
+
+		bool CreateSchedule(SearchRequestHeader request, SearchScheduleHeader &scheduleHeader);
+		static SearchErrorHeader CreateError(SearchRequestHeader request);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,254 @@
+#include "central-server.h"
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <arpa/inet.h>
+
+#include "type-header.h"
+#include "utilities.h"
+#include "radius-filter.h"
+#include "service-catalog.h"
+
+NS_LOG_COMPONENT_DEFINE("CentralServer");
+
+/*
+ * ns-3 packets share global free lists and uid counters that are not thread safe, so
+ * datagrams are decoded and encoded under the codec mutex. Matching runs concurrently
+ * on registry snapshots, and each worker publishes its notifications once per batch.
+ */
+
+volatile sig_atomic_t CentralServer::running = 0;
+
+pthread_mutex_t CentralServer::codec = PTHREAD_MUTEX_INITIALIZER;
+
+CentralServer::CentralServer(CentralMatcher &matcher, int port, int nThreads) : matcher(matcher) {
+	NS_LOG_FUNCTION(this << port << nThreads);
+	this->port = port;
+	this->nThreads = nThreads > 0 ? nThreads : 1;
+	lastExpiry = 0;
+}
+
+CentralServer::~CentralServer() {
+	NS_LOG_FUNCTION(this);
+	for(std::vector<SERVER_WORKER>::iterator i = workers.begin(); i != workers.end(); i++) {
+		close(i->epoll);
+		close(i->socket);
+	}
+}
+
+void CentralServer::Stop(int signalNumber) {
+	running = 0;
+}
+
+int CentralServer::CreateSocket() {
+	NS_LOG_FUNCTION(this);
+	int fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+	if(fd < 0) {
+		NS_FATAL_ERROR("Unable to create socket: " << strerror(errno));
+	}
+	int enable = 1;
+	if(setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable)) < 0) {
+		NS_FATAL_ERROR("Unable to set SO_REUSEPORT: " << strerror(errno));
+	}
+	sockaddr_in local;
+	memset(&local, 0, sizeof(local));
+	local.sin_family = AF_INET;
+	local.sin_addr.s_addr = htonl(INADDR_ANY);
+	local.sin_port = htons(port);
+	if(bind(fd, (sockaddr *) &local, sizeof(local)) < 0) {
+		NS_FATAL_ERROR("Unable to bind port " << port << ": " << strerror(errno));
+	}
+	return fd;
+}
+
+void CentralServer::Run() {
+	NS_LOG_FUNCTION(this);
+	//Lazy singletons used while matching must exist before the workers start, the catalog is built by GetSize
+	ServiceCatalog::GetSize();
+	NS_LOG_INFO("Radius filter uses " << RadiusFilter::GetInstructionSet());
+	Simulator::Now();
+	workers.resize(nThreads);
+	for(int i = 0; i < nThreads; i++) {
+		SERVER_WORKER &worker = workers[i];
+		memset(&worker, 0, sizeof(worker));
+		worker.id = i;
+		worker.server = this;
+		worker.socket = CreateSocket();
+		worker.epoll = epoll_create(1);
+		if(worker.epoll < 0) {
+			NS_FATAL_ERROR("Unable to create epoll instance: " << strerror(errno));
+		}
+		epoll_event event;
+		memset(&event, 0, sizeof(event));
+		event.events = EPOLLIN;
+		event.data.fd = worker.socket;
+		epoll_ctl(worker.epoll, EPOLL_CTL_ADD, worker.socket, &event);
+	}
+	lastExpiry = Utilities::GetWallClockTime() * 1000;
+	running = 1;
+	signal(SIGINT, CentralServer::Stop);
+	signal(SIGTERM, CentralServer::Stop);
+	std::cout << "Central server listening on UDP port " << port << " with " << nThreads << " workers" << std::endl;
+	for(int i = 0; i < nThreads; i++) {
+		pthread_create(&workers[i].thread, NULL, CentralServer::RunWorker, &workers[i]);
+	}
+	for(int i = 0; i < nThreads; i++) {
+		pthread_join(workers[i].thread, NULL);
+	}
+	signal(SIGINT, SIG_DFL);
+	signal(SIGTERM, SIG_DFL);
+	for(int i = 0; i < nThreads; i++) {
+		std::cout << "Worker " << workers[i].id << ": requests=" << workers[i].requests << " notifications=" << workers[i].notifications
+				<< " responses=" << workers[i].responses << " errors=" << workers[i].errors << " invalid=" << workers[i].invalid << std::endl;
+	}
+	std::cout << "Evictions: " << matcher.GetEvictions() << std::endl;
+}
+
+void * CentralServer::RunWorker(void *worker) {
+	SERVER_WORKER *serverWorker = (SERVER_WORKER *) worker;
+	epoll_event event;
+	while(running) {
+		int nEvents = epoll_wait(serverWorker->epoll, &event, 1, SERVER_POLL_TIMEOUT);
+		if(nEvents < 0 && errno != EINTR) {
+			NS_LOG_WARN("Worker " << serverWorker->id << " stopped waiting: " << strerror(errno));
+			break;
+		}
+		if(nEvents > 0) {
+			serverWorker->server->ReceiveMessages(serverWorker);
+		}
+		if(serverWorker->id == 0) {
+			serverWorker->server->ExpireNodes();
+		}
+	}
+	return NULL;
+}
+
+/*
+ * Called by the first worker only, which wakes up at least every SERVER_POLL_TIMEOUT, so the
+ * registry is aged about once per hello period, the granularity of its expiry wheel.
+ */
+void CentralServer::ExpireNodes() {
+	if(matcher.GetExpiryTime() <= 0) {
+		return;
+	}
+	double now = Utilities::GetWallClockTime() * 1000;
+	if(now - lastExpiry < HELLO_TIME * 1000) {
+		return;
+	}
+	lastExpiry = now;
+	int nEvicted = matcher.ExpireNodes(now);
+	if(nEvicted > 0) {
+		NS_LOG_DEBUG("Worker 0 evicted " << nEvicted << " nodes");
+		matcher.Publish();
+	}
+}
+
+void CentralServer::ReceiveMessages(SERVER_WORKER *worker) {
+	uint8_t data[MAX_DATAGRAM_SIZE];
+	sockaddr_in source;
+	socklen_t sourceLength;
+	bool notified = false;
+	while(running) {
+		sourceLength = sizeof(source);
+		ssize_t size = recvfrom(worker->socket, data, sizeof(data), 0, (sockaddr *) &source, &sourceLength);
+		if(size < 0) {
+			if(errno == EINTR) {
+				continue;
+			}
+			if(errno != EAGAIN && errno != EWOULDBLOCK) {
+				NS_LOG_WARN("Worker " << worker->id << " failed to receive: " << strerror(errno));
+			}
+			break;
+		}
+		ReceiveMessage(worker, data, (uint32_t) size, source, notified);
+	}
+	if(notified) {
+		matcher.Publish();
+	}
+}
+
+void CentralServer::ReceiveMessage(SERVER_WORKER *worker, const uint8_t *data, uint32_t size, const sockaddr_in &source, bool &notified) {
+	TypeHeader typeHeader;
+	SearchRequestHeader requestHeader;
+	SearchNotificationHeader notificationHeader;
+	SearchNotificationDeltaHeader deltaHeader;
+	pthread_mutex_lock(&codec);
+	Ptr<Packet> packet = Create<Packet>(data, size);
+	if(size >= typeHeader.GetSerializedSize()) {
+		packet->RemoveHeader(typeHeader);
+	}
+	//Datagrams come from anyone, so headers too short for what they announce are not decoded
+	bool valid = typeHeader.IsValid();
+	if(valid && typeHeader.GetType() == STRATOS_SEARCH_REQUEST) {
+		packet->RemoveHeader(requestHeader);
+		valid = requestHeader.IsValid();
+	} else if(valid && typeHeader.GetType() == STRATOS_SEARCH_NOTIFICATION) {
+		packet->RemoveHeader(notificationHeader);
+		valid = notificationHeader.IsValid();
+	} else if(valid && typeHeader.GetType() == STRATOS_SEARCH_NOTIFICATION_DELTA) {
+		packet->RemoveHeader(deltaHeader);
+		valid = deltaHeader.IsValid();
+	}
+	packet = NULL;
+	pthread_mutex_unlock(&codec);
+	if(!valid) {
+		NS_LOG_DEBUG("Worker " << worker->id << " received an invalid or truncated search message");
+		worker->invalid++;
+		return;
+	}
+	SearchScheduleHeader scheduleHeader;
+	//Notification timestamps are on the sender clock, and only present with a velocity
+	double now = Utilities::GetWallClockTime() * 1000;
+	switch(typeHeader.GetType()) {
+		case STRATOS_SEARCH_NOTIFICATION:
+			NS_LOG_DEBUG("Worker " << worker->id << " received notification: " << notificationHeader);
+			worker->notifications++;
+			matcher.UpdateNode(notificationHeader, now);
+			notified = true;
+			break;
+		case STRATOS_SEARCH_NOTIFICATION_DELTA:
+			NS_LOG_DEBUG("Worker " << worker->id << " received notification delta: " << deltaHeader);
+			worker->notifications++;
+			matcher.UpdateNode(deltaHeader, now);
+			notified = true;
+			break;
+		case STRATOS_SEARCH_REQUEST:
+			NS_LOG_DEBUG("Worker " << worker->id << " received request: " << requestHeader);
+			worker->requests++;
+			if(matcher.CreateSchedule(requestHeader, scheduleHeader)) {
+				worker->responses++;
+				SendMessage(worker, STRATOS_SEARCH_RESPONSE, scheduleHeader, source);
+			} else {
+				worker->errors++;
+				SendMessage(worker, STRATOS_SEARCH_ERROR, CentralMatcher::CreateError(requestHeader), source);
+			}
+			break;
+		default:
+			NS_LOG_WARN("Worker " << worker->id << " received an unknown search message");
+			worker->invalid++;
+			break;
+	}
+}
+
+void CentralServer::SendMessage(SERVER_WORKER *worker, MessageType type, const Header &header, const sockaddr_in &destination) {
+	std::vector<uint8_t> data;
+	pthread_mutex_lock(&codec);
+	Ptr<Packet> packet = Create<Packet>();
+	packet->AddHeader(header);
+	TypeHeader typeHeader(type);
+	packet->AddHeader(typeHeader);
+	data.resize(packet->GetSize());
+	packet->CopyData(&data[0], data.size());
+	packet = NULL;
+	pthread_mutex_unlock(&codec);
+	if(sendto(worker->socket, &data[0], data.size(), 0, (const sockaddr *) &destination, sizeof(destination)) < 0) {
+		NS_LOG_WARN("Worker " << worker->id << " failed to send to " << inet_ntoa(destination.sin_addr) << ": " << strerror(errno));
+	}
+}
\ No newline at end of file
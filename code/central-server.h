@@ -0,0 +1,66 @@
+#ifndef CENTRAL_SERVER_H
+#define CENTRAL_SERVER_H
+
+#include <vector>
+#include <stdint.h>
+#include <signal.h>
+#include <pthread.h>
+#include <netinet/in.h>
+
+#include "definitions.h"
+#include "central-matcher.h"
+
+using namespace ns3;
+
+class CentralServer;
+
+struct SERVER_WORKER {
+	int id;
+	int socket;
+	int epoll;
+	pthread_t thread;
+	CentralServer *server;
+	uint64_t requests;
+	uint64_t notifications;
+	uint64_t responses;
+	uint64_t errors;
+	uint64_t invalid;
+};
+
+/*
+ * Serves the central protocol over real UDP sockets. Every worker thread owns a socket bound
+ * to the same port with SO_REUSEPORT, so the kernel spreads the datagrams among them, and
+ * waits on its own epoll instance. Replies are sent back to the source of each datagram.
+ * Nodes are last seen when their notifications arrive, on the server clock, and the first
+ * worker ages the registry once per hello period when an expiry is set.
+ */
+class CentralServer {
+
+	public:
+		CentralServer(CentralMatcher &matcher, int port = SEARCH_PORT, int nThreads = SERVER_THREADS);
+		~CentralServer();
+
+	private:
+		int port;
+		int nThreads;
+		CentralMatcher &matcher;
+		std::vector<SERVER_WORKER> workers;
+		double lastExpiry;
+
+		static volatile sig_atomic_t running;
+		static pthread_mutex_t codec;
+
+		static void Stop(int signalNumber);
+		static void * RunWorker(void *worker);
+
+		int CreateSocket();
+		void ExpireNodes();
+		void ReceiveMessages(SERVER_WORKER *worker);
+		void ReceiveMessage(SERVER_WORKER *worker, const uint8_t *data, uint32_t size, const sockaddr_in &source, bool &notified);
+		void SendMessage(SERVER_WORKER *worker, MessageType type, const Header &header, const sockaddr_in &destination);
+
+	public:
+		void Run();
+};
+
+#endif
\ No newline at end of file
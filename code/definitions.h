@@ -2,12 +2,25 @@
 #define DEFINITIONS_H
 
 #include <string>
+#include <stdint.h>
 #include <sys/types.h>
 
 #define MAX_TRIES 2
 
 #define HELLO_TIME 2 //seconds
 
+#define KEEPALIVE_TIME 10 //seconds
+
+#define NOTIFICATION_DISTANCE 10 //meters
+
+#define UDP_IP_HEADERS_SIZE 28 //bytes
+
+#define VELOCITY_SCALE 1000 //velocities travel in mm/s
+
+#define MAX_PREDICTION_TIME 10 //seconds
+
+#define MAX_NODE_SPEED 50 //m/s, faster reported velocities are clamped to it
+
 #define MIN_JITTER 0.001 //1ms
 
 #define MAX_JITTER 0.01 //10ms
@@ -20,6 +33,8 @@
 
 #define MAX_DISTANCE 1000 //meters
 
+#define GRID_CELL_SIZE 200 //meters
+
 #define PACKET_LENGTH 256 //bytes
 
 #define MAX_REQUEST_TIME 50 //seconds
@@ -30,25 +45,98 @@
 
 #define MAX_RESPONSE_WAIT_TIME 1 //second
 
+#define MIN_RETRANSMISSION_TIMEOUT 0.05 //50ms
+
+#define MAX_RETRANSMISSION_TIMEOUT 8 //seconds
+
 #define TOTAL_SIMULATION_TIME 100 //seconds
 
 #define TOTAL_NUMBER_OF_NODES 100
 
+#define UNKNOWN_SERVICE -1
+
+#define SERVICE_STRING_ID 0xFFFF //wire id of services sent by name
+
+#define MAX_OFFERED_SERVICES 16
+
+#define MAX_SERVICE_NAMES_SIZE 256 //bytes
+
+#define BUILT_IN_NUMBER_OF_SERVICES 36
+
+#define SERVER_THREADS 4
+
+#define SERVER_POLL_TIMEOUT 200 //ms
+
+#define MAX_DATAGRAM_SIZE 65507 //bytes
+
+#define NUMBER_OF_RANDOM_STREAMS 4
+
+#define INITIAL_SESSION_SLOTS 16 //power of two
+
+#define MAX_SERVICE_PATH_DEPTH 15 //one digit per nibble, the last nibble is always zero
+
 struct POSITION {
 	double x;
 	double y;
 };
 
+struct VELOCITY {
+	double x;
+	double y;
+};
+
+struct MOTION {
+	VELOCITY velocity;
+	double timestamp;
+};
+
 struct NEIGHBOR {
 	uint address;
 	double lastSeen;
 };
 
+struct RTT_ESTIMATE {
+	double srtt;
+	double rttvar;
+	double minRtt;
+};
+
+struct TRANSMISSION {
+	double firstTime;
+	double lastTime;
+	int nRetransmits;
+};
+
+struct PROVIDER_RESULT {
+	int quota;
+	int nPackets;
+	double startTime;
+	double firstPacketTime;
+	double lastPacketTime;
+	double endTime;
+};
+
+struct SCHEDULE_CANDIDATE {
+	uint address;
+	int semanticDistance;
+};
+
 struct OFFERED_SERVICE {
 	std::string service;
 	int semanticDistance;
 };
 
+struct SERVICE_PATH {
+	uint64_t digits;
+	int depth;
+};
+
+struct SWEEP_JOB {
+	std::string parameter;
+	int value;
+	int run;
+};
+
 enum MessageType {
 	STRATOS = 0,
 	STRATOS_SEARCH_REQUEST = 1,
@@ -57,7 +145,21 @@ enum MessageType {
 	STRATOS_SERVICE_REQUEST = 4,
 	STRATOS_SERVICE_RESPONSE = 5,
 	STRATOS_SERVICE_ERROR = 6,
-	STRATOS_SEARCH_NOTIFICATION = 7
+	STRATOS_SEARCH_NOTIFICATION = 7,
+	STRATOS_SEARCH_NOTIFICATION_DELTA = 8
+};
+
+enum NotificationField {
+	STRATOS_NOTIFICATION_POSITION = 1,
+	STRATOS_NOTIFICATION_SERVICES = 2,
+	STRATOS_NOTIFICATION_VELOCITY = 4
+};
+
+enum RandomStream {
+	STRATOS_JITTER_STREAM = 0,
+	STRATOS_WORKLOAD_STREAM = 1,
+	STRATOS_ONTOLOGY_STREAM = 2,
+	STRATOS_MOBILITY_STREAM = 3
 };
 
 enum Flag {
@@ -0,0 +1,66 @@
+#include "expiry-wheel.h"
+
+#include "ns3/core-module.h"
+
+#include <cmath>
+
+NS_LOG_COMPONENT_DEFINE("ExpiryWheel");
+
+ExpiryWheel::ExpiryWheel(double tick) {
+	NS_LOG_FUNCTION(this << tick);
+	this->tick = tick;
+	currentTick = 0;
+	size = 0;
+	buckets.resize(2);
+}
+
+/*
+ * Deadlines are at most a timeout away, so with two more buckets than ticks in a timeout a node
+ * never lands in the bucket being emptied. Nodes already scheduled are kept.
+ */
+void ExpiryWheel::SetTimeout(double timeout) {
+	NS_LOG_FUNCTION(this << timeout);
+	int nBuckets = (int) ceil(timeout / tick) + 2;
+	if(nBuckets <= (int) buckets.size()) {
+		return;
+	}
+	std::vector<std::vector<uint> > scheduled;
+	scheduled.swap(buckets);
+	buckets.resize(nBuckets);
+	for(uint i = 0; i < scheduled.size(); i++) {
+		//Bucket i holds the ticks congruent with i, the first of them after the current one is due next
+		int64_t dueTick = currentTick + 1 + (((int64_t) i - currentTick - 1) % (int64_t) scheduled.size() + scheduled.size()) % scheduled.size();
+		std::vector<uint> &bucket = buckets[dueTick % nBuckets];
+		bucket.insert(bucket.end(), scheduled[i].begin(), scheduled[i].end());
+	}
+}
+
+/*
+ * A node is due in the first tick at or after its deadline. Deadlines already past are due at the
+ * next advance and those too far ahead are checked at the farthest tick of the wheel.
+ */
+void ExpiryWheel::Schedule(uint node, double deadline) {
+	int64_t dueTick = (int64_t) ceil(deadline / tick);
+	int64_t lastTick = currentTick + buckets.size() - 1;
+	dueTick = std::max(currentTick + 1, std::min(dueTick, lastTick));
+	buckets[dueTick % buckets.size()].push_back(node);
+	size++;
+}
+
+void ExpiryWheel::Advance(double now, std::vector<uint> &due) {
+	NS_LOG_FUNCTION(this << now);
+	int64_t nowTick = (int64_t) floor(now / tick);
+	//Past a whole turn every bucket is due once
+	int64_t fromTick = std::max(currentTick + 1, nowTick - (int64_t) buckets.size() + 1);
+	for(int64_t t = fromTick; t <= nowTick; t++) {
+		std::vector<uint> &bucket = buckets[t % buckets.size()];
+		due.insert(due.end(), bucket.begin(), bucket.end());
+		size -= bucket.size();
+		bucket.clear();
+	}
+	currentTick = std::max(currentTick, nowTick);
+}
+
+int ExpiryWheel::GetSize() const {
+	return size;
+}
\ No newline at end of file
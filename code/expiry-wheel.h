@@ -0,0 +1,33 @@
+#ifndef EXPIRY_WHEEL_H
+#define EXPIRY_WHEEL_H
+
+#include <vector>
+#include <stdint.h>
+
+#include "definitions.h"
+
+/*
+ * Timer wheel of node deadlines, with one bucket per tick of time. Advancing the wheel returns the
+ * nodes of the buckets it went past, whose deadlines have all passed. A node is scheduled once and
+ * refreshing it does not touch the wheel: it is up to the caller to check whether a due node was
+ * heard from since, and to schedule it again at its new deadline if so.
+ */
+class ExpiryWheel {
+
+	public:
+		ExpiryWheel(double tick = HELLO_TIME * 1000);
+
+	private:
+		double tick;
+		int64_t currentTick;
+		int size;
+		std::vector<std::vector<uint> > buckets;
+
+	public:
+		void SetTimeout(double timeout);
+		void Schedule(uint node, double deadline);
+		void Advance(double now, std::vector<uint> &due);
+		int GetSize() const;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,153 @@
+#include "grid-index.h"
+
+#include "ns3/core-module.h"
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+#include "radius-filter.h"
+#include "position-application.h"
+
+NS_LOG_COMPONENT_DEFINE("GridIndex");
+
+//Cells past this are merged into the outermost one, far from where GetCellStart(cell + 1) overflows
+#define MAX_GRID_CELL 1073741824.0
+
+GridIndex::GridIndex(double cellSize) {
+	NS_LOG_FUNCTION(this << cellSize);
+	this->cellSize = cellSize;
+}
+
+/*
+ * Far off coordinates, such as the corners of a huge query, are kept to cells an int can step past.
+ */
+int GridIndex::GetCellIndex(double coordinate) const {
+	double cell = floor(coordinate / cellSize);
+	return (int) std::max(-MAX_GRID_CELL, std::min(cell, MAX_GRID_CELL));
+}
+
+CELL GridIndex::GetCell(POSITION position) const {
+	return std::make_pair(GetCellIndex(position.x), GetCellIndex(position.y));
+}
+
+double GridIndex::GetCellStart(int cell) const {
+	return cell * cellSize;
+}
+
+int GridIndex::GetSize() const {
+	return nodes.size();
+}
+
+void GridIndex::Remove(uint node) {
+	NS_LOG_FUNCTION(this << node);
+	std::map<uint, CELL>::iterator i = nodes.find(node);
+	if(i == nodes.end()) {
+		return;
+	}
+	std::map<CELL, GRID_CELL>::iterator cell = cells.find(i->second);
+	GRID_CELL &entries = cell->second;
+	int k = std::find(entries.nodes.begin(), entries.nodes.end(), node) - entries.nodes.begin();
+	entries.nodes[k] = entries.nodes.back();
+	entries.x[k] = entries.x.back();
+	entries.y[k] = entries.y.back();
+	entries.nodes.pop_back();
+	entries.x.pop_back();
+	entries.y.pop_back();
+	if(entries.nodes.empty()) {
+		cells.erase(cell);
+	}
+	nodes.erase(i);
+}
+
+void GridIndex::Update(uint node, POSITION position) {
+	NS_LOG_FUNCTION(this << node);
+	CELL cell = GetCell(position);
+	std::map<uint, CELL>::iterator i = nodes.find(node);
+	if(i != nodes.end() && i->second != cell) {
+		NS_LOG_DEBUG("Node " << node << " moved from cell (" << i->second.first << ", " << i->second.second << ") to (" << cell.first << ", " << cell.second << ")");
+		Remove(node);
+		i = nodes.end();
+	}
+	GRID_CELL &entries = cells[cell];
+	if(i == nodes.end()) {
+		nodes[node] = cell;
+		entries.nodes.push_back(node);
+		entries.x.push_back(position.x);
+		entries.y.push_back(position.y);
+		return;
+	}
+	int k = std::find(entries.nodes.begin(), entries.nodes.end(), node) - entries.nodes.begin();
+	entries.x[k] = position.x;
+	entries.y[k] = position.y;
+}
+
+/*
+ * Cells entirely inside the circle take all their nodes, and those crossing it run the radius filter
+ * over their coordinates.
+ */
+void GridIndex::AddNodesInRange(CELL cell, const GRID_CELL &entries, POSITION center, double radius, std::vector<uint> &found, std::vector<int> &indices) const {
+	POSITION corner;
+	POSITION nearest;
+	//Cells are widened a little so that rounding in GetCell never leaves a node outside its cell bounds
+	double slack = cellSize * 1e-9;
+	double left = GetCellStart(cell.first) - slack;
+	double right = GetCellStart(cell.first + 1) + slack;
+	double bottom = GetCellStart(cell.second) - slack;
+	double top = GetCellStart(cell.second + 1) + slack;
+	//The outermost cells also hold the nodes beyond them, so only their nodes bound them
+	bool bounded = fabs(cell.first) < MAX_GRID_CELL && fabs(cell.second) < MAX_GRID_CELL;
+	nearest.x = std::max(left, std::min(center.x, right));
+	nearest.y = std::max(bottom, std::min(center.y, top));
+	if(bounded && PositionApplication::CalculateDistanceFromTo(nearest, center) > radius) {
+		return;
+	}
+	corner.x = fabs(center.x - left) > fabs(center.x - right) ? left : right;
+	corner.y = fabs(center.y - bottom) > fabs(center.y - top) ? bottom : top;
+	if(bounded && PositionApplication::CalculateDistanceFromTo(corner, center) <= radius) {
+		found.insert(found.end(), entries.nodes.begin(), entries.nodes.end());
+		return;
+	}
+	indices.resize(entries.nodes.size());
+	int nInside = RadiusFilter::Filter(&entries.x[0], &entries.y[0], entries.nodes.size(), center, radius, &indices[0]);
+	for(int k = 0; k < nInside; k++) {
+		found.push_back(entries.nodes[indices[k]]);
+	}
+}
+
+/*
+ * The cells overlapping the bounding box of the circle are looked up one by one, unless there are more
+ * of them than occupied cells, as with a radius widened by a fast node. Then the occupied cells are
+ * walked instead, so a query never costs more than a pass over the grid.
+ */
+std::list<uint> GridIndex::GetNodesInRange(POSITION center, double radius) const {
+	NS_LOG_FUNCTION(this << radius);
+	POSITION corner;
+	std::vector<uint> found;
+	std::vector<int> indices;
+	corner.x = center.x - radius;
+	corner.y = center.y - radius;
+	CELL from = GetCell(corner);
+	corner.x = center.x + radius;
+	corner.y = center.y + radius;
+	CELL to = GetCell(corner);
+	double nBoxCells = (to.first - (double) from.first + 1) * (to.second - (double) from.second + 1);
+	if(nBoxCells > cells.size()) {
+		for(std::map<CELL, GRID_CELL>::const_iterator cell = cells.begin(); cell != cells.end(); cell++) {
+			AddNodesInRange(cell->first, cell->second, center, radius, found, indices);
+		}
+	} else {
+		for(int x = from.first; x <= to.first; x++) {
+			for(int y = from.second; y <= to.second; y++) {
+				std::map<CELL, GRID_CELL>::const_iterator cell = cells.find(std::make_pair(x, y));
+				if(cell != cells.end()) {
+					AddNodesInRange(cell->first, cell->second, center, radius, found, indices);
+				}
+			}
+		}
+	}
+	//Same order as a scan over the address ordered registry
+	std::sort(found.begin(), found.end());
+	NS_LOG_DEBUG("There are " << found.size() << " nodes within " << radius << "m of (" << center.x << ", " << center.y << ")");
+	return std::list<uint>(found.begin(), found.end());
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+#ifndef GRID_INDEX_H
+#define GRID_INDEX_H
+
+#include <map>
+#include <list>
+#include <vector>
+
+#include "definitions.h"
+
+typedef std::pair<int, int> CELL;
+
+//Nodes of a cell with their coordinates kept contiguous, so the radius filter can stream through them
+struct GRID_CELL {
+	std::vector<uint> nodes;
+	std::vector<double> x;
+	std::vector<double> y;
+};
+
+class GridIndex {
+
+	public:
+		GridIndex(double cellSize = GRID_CELL_SIZE);
+
+	private:
+		double cellSize;
+		std::map<uint, CELL> nodes;
+		std::map<CELL, GRID_CELL> cells;
+
+		int GetCellIndex(double coordinate) const;
+		CELL GetCell(POSITION position) const;
+		double GetCellStart(int cell) const;
+		void AddNodesInRange(CELL cell, const GRID_CELL &entries, POSITION center, double radius, std::vector<uint> &found, std::vector<int> &indices) const;
+
+	public:
+		int GetSize() const;
+		void Remove(uint node);
+		void Update(uint node, POSITION position);
+		std::list<uint> GetNodesInRange(POSITION center, double radius) const;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,294 @@
+#include "kernel-benchmark.h"
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+
+#include <list>
+#include <cmath>
+#include <algorithm>
+
+#include "utilities.h"
+#include "service-path.h"
+#include "central-matcher.h"
+#include "service-catalog.h"
+#include "search-application.h"
+#include "results-application.h"
+#include "ontology-application.h"
+#include "position-application.h"
+#include "schedule-application.h"
+
+#define KERNEL_MIN_TIME 0.2 //seconds
+
+NS_LOG_COMPONENT_DEFINE("KernelBenchmark");
+
+void KernelBenchmark::Run(std::vector<int> sizes, std::ostream &stream) {
+	NS_LOG_FUNCTION(&stream);
+	stream << "kernel,size,iterations,seconds,nsPerCall,nsPerElement,checksum" << std::endl;
+	for(std::vector<int>::iterator i = sizes.begin(); i != sizes.end(); i++) {
+		if(*i <= 0) {
+			continue;
+		}
+		RunSemanticDistance(*i, stream);
+		RunBestOfferedService(*i, stream);
+		RunDistance(*i, stream);
+		RunCentralFilter(*i, stream);
+		RunScheduleSelection(*i, stream);
+		RunSelectBestResponse(*i, stream);
+		RunCreateSchedule(*i, stream);
+		RunScheduleHeader(*i, stream);
+	}
+}
+
+/*
+ * Every call of a kernel processes size elements, so nsPerElement compares sizes. The checksum
+ * depends on every result, so the compiler can not drop the calls, and should not change
+ * between builds that are supposed to give the same results.
+ */
+void KernelBenchmark::Report(std::ostream &stream, std::string kernel, int size, long iterations, double time, long checksum) {
+	stream << kernel << "," << size << "," << iterations << "," << time
+			<< "," << (time * 1000000000 / iterations)
+			<< "," << (time * 1000000000 / iterations / size)
+			<< "," << checksum << std::endl;
+}
+
+void KernelBenchmark::RunSemanticDistance(int size, std::ostream &stream) {
+	NS_LOG_FUNCTION(size);
+	std::vector<std::string> required(size);
+	std::vector<std::string> offered(size);
+	for(int i = 0; i < size; i++) {
+		required[i] = OntologyApplication::GetRandomService();
+		offered[i] = OntologyApplication::GetRandomService();
+	}
+	long checksum = 0;
+	long iterations = 0;
+	double time;
+	double start = Utilities::GetWallClockTime();
+	do {
+		for(int i = 0; i < size; i++) {
+			checksum += OntologyApplication::SemanticDistance(required[i], offered[i]);
+		}
+		iterations++;
+	} while((time = Utilities::GetWallClockTime() - start) < KERNEL_MIN_TIME);
+	Report(stream, "semanticDistance", size, iterations, time, checksum / iterations);
+}
+
+void KernelBenchmark::RunBestOfferedService(int size, std::ostream &stream) {
+	NS_LOG_FUNCTION(size);
+	std::string required = OntologyApplication::GetRandomService();
+	std::list<std::string> offered;
+	for(int i = 0; i < size; i++) {
+		offered.push_back(OntologyApplication::GetRandomService());
+	}
+	long checksum = 0;
+	long iterations = 0;
+	double time;
+	double start = Utilities::GetWallClockTime();
+	do {
+		checksum += OntologyApplication::GetBestOfferedService(required, offered).semanticDistance;
+		iterations++;
+	} while((time = Utilities::GetWallClockTime() - start) < KERNEL_MIN_TIME);
+	Report(stream, "bestOfferedService", size, iterations, time, checksum / iterations);
+	std::vector<int> offeredIds = ServiceCatalog::GetServiceIds(offered);
+	int requiredId = ServiceCatalog::GetServiceId(required);
+	checksum = 0;
+	iterations = 0;
+	start = Utilities::GetWallClockTime();
+	do {
+		checksum += OntologyApplication::GetBestOfferedService(requiredId, &offeredIds[0], size).semanticDistance;
+		iterations++;
+	} while((time = Utilities::GetWallClockTime() - start) < KERNEL_MIN_TIME);
+	Report(stream, "bestOfferedServiceIds", size, iterations, time, checksum / iterations);
+	SERVICE_PATH requiredPath;
+	std::vector<SERVICE_PATH> offeredPaths;
+	ServicePath::Pack(required, requiredPath);
+	ServicePath::Pack(offered, offeredPaths);
+	std::vector<int> semanticDistances(size);
+	checksum = 0;
+	iterations = 0;
+	start = Utilities::GetWallClockTime();
+	do {
+		ServicePath::SemanticDistances(requiredPath, &offeredPaths[0], size, &semanticDistances[0]);
+		checksum += *std::min_element(semanticDistances.begin(), semanticDistances.end());
+		iterations++;
+	} while((time = Utilities::GetWallClockTime() - start) < KERNEL_MIN_TIME);
+	Report(stream, "bestOfferedServicePaths", size, iterations, time, checksum / iterations);
+}
+
+void KernelBenchmark::RunDistance(int size, std::ostream &stream) {
+	NS_LOG_FUNCTION(size);
+	std::vector<POSITION> from(size);
+	std::vector<POSITION> to(size);
+	for(int i = 0; i < size; i++) {
+		from[i].x = Utilities::Random(0, MAX_DISTANCE);
+		from[i].y = Utilities::Random(0, MAX_DISTANCE);
+		to[i].x = Utilities::Random(0, MAX_DISTANCE);
+		to[i].y = Utilities::Random(0, MAX_DISTANCE);
+	}
+	double sum = 0;
+	long iterations = 0;
+	double time;
+	double start = Utilities::GetWallClockTime();
+	do {
+		for(int i = 0; i < size; i++) {
+			sum += PositionApplication::CalculateDistanceFromTo(from[i], to[i]);
+		}
+		iterations++;
+	} while((time = Utilities::GetWallClockTime() - start) < KERNEL_MIN_TIME);
+	Report(stream, "distance", size, iterations, time, (long) (sum / iterations));
+}
+
+/*
+ * A registry of size nodes at the density of the default scenario, queried with the request
+ * distances of the simulation, through the grid index and through the linear scan.
+ */
+void KernelBenchmark::RunCentralFilter(int size, std::ostream &stream) {
+	NS_LOG_FUNCTION(size);
+	const int nRequests = 64;
+	double areaSize = MAX_DISTANCE * sqrt(size / (double) TOTAL_NUMBER_OF_NODES);
+	CentralMatcher matcher;
+	for(int i = 1; i <= size; i++) {
+		POSITION position;
+		position.x = Utilities::Random(0, areaSize);
+		position.y = Utilities::Random(0, areaSize);
+		std::list<std::string> offeredServices;
+		offeredServices.push_back(OntologyApplication::GetRandomService());
+		matcher.registry.Update(i, position, offeredServices, 0);
+	}
+	matcher.registry.Publish();
+	std::vector<SearchRequestHeader> requests(nRequests);
+	for(int i = 0; i < nRequests; i++) {
+		POSITION position;
+		position.x = Utilities::Random(0, areaSize);
+		position.y = Utilities::Random(0, areaSize);
+		requests[i].SetRequestPosition(position);
+		requests[i].SetMaxDistanceAllowed(Utilities::Random(MIN_REQUEST_DISTANCE, MAX_REQUEST_DISTANCE));
+	}
+	int ticket;
+	const REGISTRY_SNAPSHOT *snapshot = matcher.registry.Acquire(ticket);
+	for(int spatialIndex = 1; spatialIndex >= 0; spatialIndex--) {
+		matcher.SetSpatialIndex(spatialIndex);
+		long checksum = 0;
+		long iterations = 0;
+		double time;
+		double start = Utilities::GetWallClockTime();
+		do {
+			checksum += matcher.FilterNodesByDistance(snapshot, requests[iterations % nRequests]).size();
+			iterations++;
+		} while((time = Utilities::GetWallClockTime() - start) < KERNEL_MIN_TIME);
+		Report(stream, spatialIndex ? "centralFilter" : "centralFilterLinear", size, iterations, time, checksum / iterations);
+	}
+	matcher.registry.Release(ticket);
+}
+
+void KernelBenchmark::RunScheduleSelection(int size, std::ostream &stream) {
+	NS_LOG_FUNCTION(size);
+	const int nRequests = 64;
+	CentralMatcher matcher;
+	//Registered in order, so node i is in slot i - 1
+	std::vector<int> nodes;
+	for(int i = 1; i <= size; i++) {
+		std::list<std::string> offeredServices;
+		offeredServices.push_back(OntologyApplication::GetRandomService());
+		offeredServices.push_back(OntologyApplication::GetRandomService());
+		matcher.registry.Update(i, POSITION(), offeredServices, 0);
+		nodes.push_back(i - 1);
+	}
+	matcher.registry.Publish();
+	std::vector<SearchRequestHeader> requests(nRequests);
+	for(int i = 0; i < nRequests; i++) {
+		requests[i].SetRequestedService(OntologyApplication::GetRandomService());
+	}
+	int ticket;
+	const REGISTRY_SNAPSHOT *snapshot = matcher.registry.Acquire(ticket);
+	long checksum = 0;
+	long iterations = 0;
+	double time;
+	double start = Utilities::GetWallClockTime();
+	do {
+		checksum += matcher.GetScheduleNodes(snapshot, nodes, requests[iterations % nRequests]).front();
+		iterations++;
+	} while((time = Utilities::GetWallClockTime() - start) < KERNEL_MIN_TIME);
+	Report(stream, "scheduleSelection", size, iterations, time, checksum / iterations);
+	matcher.registry.Release(ticket);
+}
+
+static std::list<SearchResponseHeader> CreateResponses(int size) {
+	std::list<SearchResponseHeader> responses;
+	for(int i = 1; i <= size; i++) {
+		SearchResponseHeader response;
+		OFFERED_SERVICE offeredService;
+		offeredService.service = OntologyApplication::GetRandomService();
+		offeredService.semanticDistance = (int) Utilities::Random(0, 10);
+		response.SetOfferedService(offeredService);
+		response.SetResponseAddress(Ipv4Address(i));
+		response.SetDistance(Utilities::Random(0, MAX_REQUEST_DISTANCE));
+		responses.push_back(response);
+	}
+	return responses;
+}
+
+void KernelBenchmark::RunSelectBestResponse(int size, std::ostream &stream) {
+	NS_LOG_FUNCTION(size);
+	std::list<SearchResponseHeader> responses = CreateResponses(size);
+	long checksum = 0;
+	long iterations = 0;
+	double time;
+	double start = Utilities::GetWallClockTime();
+	do {
+		checksum += SearchApplication::SelectBestResponse(responses).GetResponseAddress().Get();
+		iterations++;
+	} while((time = Utilities::GetWallClockTime() - start) < KERNEL_MIN_TIME);
+	Report(stream, "selectBestResponse", size, iterations, time, checksum / iterations);
+}
+
+/*
+ * The application is not installed on a node, so it must run without ScheduleApplication logs,
+ * which ask the node for its address.
+ */
+void KernelBenchmark::RunCreateSchedule(int size, std::ostream &stream) {
+	NS_LOG_FUNCTION(size);
+	std::list<SearchResponseHeader> responses = CreateResponses(size);
+	Ptr<ScheduleApplication> scheduleApp = CreateObject<ScheduleApplication>();
+	scheduleApp->resultsManager = CreateObject<ResultsApplication>();
+	scheduleApp->MAX_SCHEDULE_SIZE = 3;
+	long checksum = 0;
+	long iterations = 0;
+	double time;
+	double start = Utilities::GetWallClockTime();
+	do {
+		scheduleApp->schedule.clear();
+		scheduleApp->CreateSchedule(responses);
+		checksum += scheduleApp->schedule.back().GetResponseAddress().Get();
+		iterations++;
+	} while((time = Utilities::GetWallClockTime() - start) < KERNEL_MIN_TIME);
+	Report(stream, "createSchedule", size, iterations, time, checksum / iterations);
+}
+
+void KernelBenchmark::RunScheduleHeader(int size, std::ostream &stream) {
+	NS_LOG_FUNCTION(size);
+	//The number of responses travels in a U16
+	size = std::min(size, 0xFFFF);
+	SearchScheduleHeader scheduleHeader;
+	scheduleHeader.SetSchedule(CreateResponses(size));
+	Buffer buffer;
+	buffer.AddAtStart(scheduleHeader.GetSerializedSize());
+	long checksum = 0;
+	long iterations = 0;
+	double time;
+	double start = Utilities::GetWallClockTime();
+	do {
+		scheduleHeader.Serialize(buffer.Begin());
+		checksum += buffer.Begin().ReadU8();
+		iterations++;
+	} while((time = Utilities::GetWallClockTime() - start) < KERNEL_MIN_TIME);
+	Report(stream, "scheduleSerialize", size, iterations, time, checksum / iterations);
+	SearchScheduleHeader received;
+	checksum = 0;
+	iterations = 0;
+	start = Utilities::GetWallClockTime();
+	do {
+		checksum += received.Deserialize(buffer.Begin());
+		iterations++;
+	} while((time = Utilities::GetWallClockTime() - start) < KERNEL_MIN_TIME);
+	Report(stream, "scheduleDeserialize", size, iterations, time, checksum / iterations);
+}
\ No newline at end of file
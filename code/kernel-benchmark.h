@@ -0,0 +1,32 @@
+#ifndef KERNEL_BENCHMARK_H
+#define KERNEL_BENCHMARK_H
+
+#include <string>
+#include <vector>
+#include <ostream>
+
+#include "definitions.h"
+
+/*
+ * Microbenchmarks of the matching kernels, without the network stack. Every kernel is run
+ * for each input size until KERNEL_MIN_TIME has elapsed, and reported as a CSV row.
+ */
+class KernelBenchmark {
+
+	public:
+		static void Run(std::vector<int> sizes, std::ostream &stream);
+
+	private:
+		static void Report(std::ostream &stream, std::string kernel, int size, long iterations, double time, long checksum);
+
+		static void RunSemanticDistance(int size, std::ostream &stream);
+		static void RunBestOfferedService(int size, std::ostream &stream);
+		static void RunDistance(int size, std::ostream &stream);
+		static void RunCentralFilter(int size, std::ostream &stream);
+		static void RunScheduleSelection(int size, std::ostream &stream);
+		static void RunSelectBestResponse(int size, std::ostream &stream);
+		static void RunCreateSchedule(int size, std::ostream &stream);
+		static void RunScheduleHeader(int size, std::ostream &stream);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,262 @@
+#include "load-generator.h"
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+
+#include <cmath>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <algorithm>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <arpa/inet.h>
+
+#include "utilities.h"
+#include "type-header.h"
+#include "ontology-application.h"
+
+NS_LOG_COMPONENT_DEFINE("LoadGenerator");
+
+LoadGenerator::LoadGenerator(int nNodes, int nRequests, double notificationsPerRequest) {
+	NS_LOG_FUNCTION(this << nNodes << nRequests << notificationsPerRequest);
+	this->nNodes = nNodes > 0 ? nNodes : 1;
+	this->nRequests = nRequests;
+	this->notificationsPerRequest = notificationsPerRequest;
+	//Same node density as the simulated scenario
+	areaSize = MAX_DISTANCE * std::sqrt((double) this->nNodes / TOTAL_NUMBER_OF_NODES);
+	Reset();
+}
+
+void LoadGenerator::Reset() {
+	NS_LOG_FUNCTION(this);
+	positions.resize(nNodes);
+	services.resize(nNodes);
+	for(int i = 0; i < nNodes; i++) {
+		positions[i].x = Utilities::Random(0, areaSize);
+		positions[i].y = Utilities::Random(0, areaSize);
+		services[i].clear();
+		services[i].push_back(OntologyApplication::GetRandomService());
+		services[i].push_back(OntologyApplication::GetRandomService());
+	}
+	nextNode = 0;
+	pendingNotifications = 0;
+	nErrors = 0;
+	nLost = 0;
+	nNotifications = 0;
+	duration = 0;
+	latencies.clear();
+	latencies.reserve(nRequests);
+}
+
+Ipv4Address LoadGenerator::GetNodeAddress(int node) {
+	return Ipv4Address(Ipv4Address("10.0.0.0").Get() + node + 1);
+}
+
+SearchNotificationHeader LoadGenerator::CreateNotification(int node) {
+	NS_LOG_FUNCTION(this << node);
+	SearchNotificationHeader notification;
+	notification.SetNodeAddress(GetNodeAddress(node));
+	notification.SetCurrentPosition(positions[node]);
+	notification.SetOfferedServices(services[node]);
+	return notification;
+}
+
+SearchRequestHeader LoadGenerator::CreateRequest(int sequence) {
+	NS_LOG_FUNCTION(this << sequence);
+	int requester = (int) Utilities::Random(0, nNodes - 1);
+	SearchRequestHeader request;
+	//The sequence number identifies the answer of each request
+	request.SetRequestTimestamp(sequence);
+	request.SetRequestAddress(GetNodeAddress(requester));
+	request.SetRequestPosition(positions[requester]);
+	request.SetRequestedService(OntologyApplication::GetRandomService());
+	request.SetMaxDistanceAllowed(Utilities::Random(MIN_REQUEST_DISTANCE, MAX_REQUEST_DISTANCE));
+	return request;
+}
+
+std::list<SearchNotificationHeader> LoadGenerator::MoveNodes() {
+	NS_LOG_FUNCTION(this);
+	std::list<SearchNotificationHeader> notifications;
+	pendingNotifications += notificationsPerRequest;
+	while(pendingNotifications >= 1) {
+		//Up to 4m/s during a HELLO_TIME, as the mobile nodes of the simulation
+		POSITION &position = positions[nextNode];
+		position.x = std::min(areaSize, std::max(0.0, position.x + Utilities::Random(-4, 4) * HELLO_TIME));
+		position.y = std::min(areaSize, std::max(0.0, position.y + Utilities::Random(-4, 4) * HELLO_TIME));
+		notifications.push_back(CreateNotification(nextNode));
+		nextNode = (nextNode + 1) % nNodes;
+		pendingNotifications--;
+	}
+	nNotifications += notifications.size();
+	return notifications;
+}
+
+void LoadGenerator::Run(CentralMatcher &matcher) {
+	NS_LOG_FUNCTION(this);
+	Reset();
+	for(int i = 0; i < nNodes; i++) {
+		SearchNotificationHeader notification = CreateNotification(i);
+		matcher.UpdateNode(notification, notification.GetNotificationTimestamp());
+	}
+	matcher.Publish();
+	double start = Utilities::GetWallClockTime();
+	for(int i = 0; i < nRequests; i++) {
+		std::list<SearchNotificationHeader> notifications = MoveNodes();
+		for(std::list<SearchNotificationHeader>::iterator j = notifications.begin(); j != notifications.end(); j++) {
+			matcher.UpdateNode(*j, j->GetNotificationTimestamp());
+		}
+		if(!notifications.empty()) {
+			matcher.Publish();
+		}
+		SearchRequestHeader request = CreateRequest(i);
+		SearchScheduleHeader schedule;
+		double requestStart = Utilities::GetWallClockTime();
+		if(!matcher.CreateSchedule(request, schedule)) {
+			CentralMatcher::CreateError(request);
+			nErrors++;
+		}
+		latencies.push_back((Utilities::GetWallClockTime() - requestStart) * 1000000);
+	}
+	duration = Utilities::GetWallClockTime() - start;
+}
+
+void LoadGenerator::Run(std::string serverAddress, int serverPort) {
+	NS_LOG_FUNCTION(this << serverAddress << serverPort);
+	Reset();
+	int socket = CreateSocket(serverAddress, serverPort);
+	for(int i = 0; i < nNodes; i++) {
+		SendMessage(socket, STRATOS_SEARCH_NOTIFICATION, CreateNotification(i));
+		if(i % 64 == 63) {
+			//Do not overflow the receive buffer of the server
+			usleep(1000);
+		}
+	}
+	//Let the server publish the registry
+	usleep(2 * SERVER_POLL_TIMEOUT * 1000);
+	double start = Utilities::GetWallClockTime();
+	for(int i = 0; i < nRequests; i++) {
+		std::list<SearchNotificationHeader> notifications = MoveNodes();
+		for(std::list<SearchNotificationHeader>::iterator j = notifications.begin(); j != notifications.end(); j++) {
+			SendMessage(socket, STRATOS_SEARCH_NOTIFICATION, *j);
+		}
+		SearchRequestHeader request = CreateRequest(i);
+		bool isError = false;
+		double requestStart = Utilities::GetWallClockTime();
+		SendMessage(socket, STRATOS_SEARCH_REQUEST, request);
+		if(ReceiveResponse(socket, i, MAX_RESPONSE_WAIT_TIME, isError)) {
+			latencies.push_back((Utilities::GetWallClockTime() - requestStart) * 1000000);
+			nErrors += isError ? 1 : 0;
+		} else {
+			nLost++;
+		}
+	}
+	duration = Utilities::GetWallClockTime() - start;
+	close(socket);
+}
+
+int LoadGenerator::CreateSocket(std::string serverAddress, int serverPort) {
+	NS_LOG_FUNCTION(serverAddress << serverPort);
+	int fd = socket(AF_INET, SOCK_DGRAM, 0);
+	if(fd < 0) {
+		NS_FATAL_ERROR("Unable to create socket: " << strerror(errno));
+	}
+	sockaddr_in server;
+	memset(&server, 0, sizeof(server));
+	server.sin_family = AF_INET;
+	server.sin_port = htons(serverPort);
+	if(inet_aton(serverAddress.c_str(), &server.sin_addr) == 0) {
+		NS_FATAL_ERROR("Invalid server address " << serverAddress);
+	}
+	if(connect(fd, (sockaddr *) &server, sizeof(server)) < 0) {
+		NS_FATAL_ERROR("Unable to connect to " << serverAddress << ":" << serverPort << ": " << strerror(errno));
+	}
+	return fd;
+}
+
+void LoadGenerator::SendMessage(int socket, MessageType type, const Header &header) {
+	Ptr<Packet> packet = Create<Packet>();
+	packet->AddHeader(header);
+	TypeHeader typeHeader(type);
+	packet->AddHeader(typeHeader);
+	std::vector<uint8_t> data(packet->GetSize());
+	packet->CopyData(&data[0], data.size());
+	if(send(socket, &data[0], data.size(), 0) < 0) {
+		NS_LOG_WARN("Unable to send message: " << strerror(errno));
+	}
+}
+
+bool LoadGenerator::ReceiveResponse(int socket, double requestTimestamp, double timeout, bool &isError) {
+	uint8_t data[MAX_DATAGRAM_SIZE];
+	double deadline = Utilities::GetWallClockTime() + timeout;
+	while(true) {
+		int remaining = (int) ((deadline - Utilities::GetWallClockTime()) * 1000);
+		pollfd descriptor;
+		descriptor.fd = socket;
+		descriptor.events = POLLIN;
+		if(remaining <= 0 || poll(&descriptor, 1, remaining) <= 0) {
+			return false;
+		}
+		ssize_t size = recv(socket, data, sizeof(data), 0);
+		if(size <= 0) {
+			continue;
+		}
+		Ptr<Packet> packet = Create<Packet>(data, (uint32_t) size);
+		TypeHeader typeHeader;
+		packet->RemoveHeader(typeHeader);
+		if(!typeHeader.IsValid()) {
+			continue;
+		}
+		if(typeHeader.GetType() == STRATOS_SEARCH_RESPONSE) {
+			SearchScheduleHeader scheduleHeader;
+			packet->RemoveHeader(scheduleHeader);
+			if(scheduleHeader.GetRequestTimestamp() == requestTimestamp) {
+				isError = false;
+				return true;
+			}
+		} else if(typeHeader.GetType() == STRATOS_SEARCH_ERROR) {
+			SearchErrorHeader errorHeader;
+			packet->RemoveHeader(errorHeader);
+			if(errorHeader.GetRequestTimestamp() == requestTimestamp) {
+				isError = true;
+				return true;
+			}
+		}
+		//Late answer of a request that already timed out
+	}
+}
+
+double LoadGenerator::GetPercentile(const std::vector<double> &sortedLatencies, double percentile) {
+	if(sortedLatencies.empty()) {
+		return 0;
+	}
+	int index = (int) std::ceil(percentile * sortedLatencies.size()) - 1;
+	return sortedLatencies[std::max(0, index)];
+}
+
+std::vector<int> LoadGenerator::ParseList(std::string list) {
+	std::vector<int> values;
+	std::stringstream stream(list);
+	std::string value;
+	while(std::getline(stream, value, ',')) {
+		if(!value.empty()) {
+			values.push_back(atoi(value.c_str()));
+		}
+	}
+	return values;
+}
+
+void LoadGenerator::Report(std::ostream &stream, std::string mode, std::string nSchedule) {
+	NS_LOG_FUNCTION(this << mode << nSchedule);
+	std::vector<double> sortedLatencies(latencies);
+	std::sort(sortedLatencies.begin(), sortedLatencies.end());
+	stream << "load mode=" << mode << " nodes=" << nNodes << " nSchedule=" << nSchedule
+			<< " requests=" << nRequests << " notifications=" << nNotifications
+			<< " throughput=" << (duration > 0 ? latencies.size() / duration : 0) << "req/s"
+			<< " p50=" << GetPercentile(sortedLatencies, 0.5) << "us"
+			<< " p99=" << GetPercentile(sortedLatencies, 0.99) << "us"
+			<< " p999=" << GetPercentile(sortedLatencies, 0.999) << "us"
+			<< " errors=" << nErrors << " lost=" << nLost << std::endl;
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+#ifndef LOAD_GENERATOR_H
+#define LOAD_GENERATOR_H
+
+#include <list>
+#include <vector>
+#include <string>
+#include <ostream>
+
+#include "definitions.h"
+#include "central-matcher.h"
+
+using namespace ns3;
+
+/*
+ * Closed-loop load for the central protocol. N fake nodes notify their position and
+ * services, then every request is preceded by notificationsPerRequest notifications of
+ * nodes moving around, and waits for its schedule or error before the next one is sent.
+ */
+class LoadGenerator {
+
+	public:
+		LoadGenerator(int nNodes, int nRequests, double notificationsPerRequest);
+
+	private:
+		int nNodes;
+		int nRequests;
+		double notificationsPerRequest;
+		double areaSize;
+		std::vector<POSITION> positions;
+		std::vector<std::list<std::string> > services;
+
+		int nextNode;
+		double pendingNotifications;
+
+		int nErrors;
+		int nLost;
+		int nNotifications;
+		double duration;
+		std::vector<double> latencies;
+
+		void Reset();
+		Ipv4Address GetNodeAddress(int node);
+		SearchNotificationHeader CreateNotification(int node);
+		SearchRequestHeader CreateRequest(int sequence);
+		std::list<SearchNotificationHeader> MoveNodes();
+
+		static double GetPercentile(const std::vector<double> &sortedLatencies, double percentile);
+
+		static int CreateSocket(std::string serverAddress, int serverPort);
+		static void SendMessage(int socket, MessageType type, const Header &header);
+		static bool ReceiveResponse(int socket, double requestTimestamp, double timeout, bool &isError);
+
+	public:
+		static std::vector<int> ParseList(std::string list);
+
+		void Run(CentralMatcher &matcher);
+		void Run(std::string serverAddress, int serverPort);
+		void Report(std::ostream &stream, std::string mode, std::string nSchedule);
+};
+
+#endif
\ No newline at end of file
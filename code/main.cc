@@ -2,6 +2,20 @@
 
 int main(int argc, char *argv[]) {
 	Stratos test(argc, argv);
+	if(test.IsBenchmark()) {
+		return test.RunBenchmark();
+	}
+	if(test.IsServer()) {
+		test.RunServer();
+		return 0;
+	}
+	if(test.IsLoad()) {
+		test.RunLoad();
+		return 0;
+	}
+	if(test.IsSweep()) {
+		return test.RunSweep();
+	}
 	test.CreateNodes();
 	test.CreateDevices();
 	test.InstallInternetStack();
@@ -0,0 +1,383 @@
+#include "node-registry.h"
+
+#include "ns3/core-module.h"
+
+#include <cmath>
+#include <limits>
+#include <sched.h>
+#include <algorithm>
+
+#include "service-path.h"
+#include "service-catalog.h"
+
+NS_LOG_COMPONENT_DEFINE("NodeRegistry");
+
+/*
+ * Readers never lock: they pin the current epoch, load the published snapshot and unpin it when done.
+ * Writers stage their changes in next and note the nodes they touched. Two snapshots take turns: under
+ * the writer mutex, the one readers are not using is brought up to date by copying over only the nodes
+ * changed since it was last published, it becomes the current one, the epoch advances, and the other
+ * one is only reused once every reader pinned to the old epoch has released it.
+ */
+
+NodeRegistry::NodeRegistry() {
+	NS_LOG_FUNCTION(this);
+	epoch = 0;
+	readers[0] = 0;
+	readers[1] = 0;
+	next.version = 0;
+	next.maxSpeed = 0;
+	spatialIndex = true;
+	serviceIndex = false;
+	expiry = 0;
+	maxSpeed = MAX_NODE_SPEED;
+	evictions = 0;
+	current = new REGISTRY_SNAPSHOT(next);
+	spare = new REGISTRY_SNAPSHOT(next);
+	pthread_mutex_init(&writer, NULL);
+}
+
+NodeRegistry::~NodeRegistry() {
+	NS_LOG_FUNCTION(this);
+	delete current;
+	delete spare;
+	pthread_mutex_destroy(&writer);
+}
+
+void NodeRegistry::SetSpatialIndex(bool spatialIndex) {
+	NS_LOG_FUNCTION(this << spatialIndex);
+	this->spatialIndex = spatialIndex;
+}
+
+void NodeRegistry::SetServiceIndex(bool serviceIndex) {
+	NS_LOG_FUNCTION(this << serviceIndex);
+	this->serviceIndex = serviceIndex;
+}
+
+/*
+ * Nodes not heard from for longer than the expiry, in milliseconds, are evicted. Zero keeps them forever.
+ */
+void NodeRegistry::SetExpiry(double expiry) {
+	NS_LOG_FUNCTION(this << expiry);
+	pthread_mutex_lock(&writer);
+	this->expiry = expiry;
+	wheel.SetTimeout(expiry);
+	pthread_mutex_unlock(&writer);
+}
+
+double NodeRegistry::GetExpiry() const {
+	return expiry;
+}
+
+/*
+ * Reported velocities faster than this, in m/s, are clamped to it, as the grid is queried with the
+ * radius widened by how far the fastest node may have moved.
+ */
+void NodeRegistry::SetMaxSpeed(double maxSpeed) {
+	NS_LOG_FUNCTION(this << maxSpeed);
+	pthread_mutex_lock(&writer);
+	this->maxSpeed = maxSpeed;
+	pthread_mutex_unlock(&writer);
+}
+
+uint64_t NodeRegistry::GetEvictions() const {
+	return evictions;
+}
+
+/*
+ * Timestamps are those of the notifications, in milliseconds, and become the last time the node was seen.
+ */
+void NodeRegistry::Update(uint node, POSITION position, std::list<std::string> services, double timestamp) {
+	NS_LOG_FUNCTION(this << node << timestamp);
+	std::vector<int> serviceIds = ServiceCatalog::GetServiceIds(services);
+	std::vector<SERVICE_PATH> servicePaths;
+	ServicePath::Pack(services, servicePaths);
+	pthread_mutex_lock(&writer);
+	if(expiry > 0 && next.nodes.Find(node) < 0) {
+		wheel.Schedule(node, timestamp + expiry);
+	}
+	int slot = next.nodes.Add(node);
+	SetServices(slot, services, serviceIds, servicePaths);
+	next.nodes.SetLastSeen(slot, timestamp);
+	SetPosition(slot, position);
+	changed.push_back(node);
+	pthread_mutex_unlock(&writer);
+}
+
+/*
+ * Same as above for services decoded off the wire, which already carry their catalog ids.
+ */
+void NodeRegistry::Update(uint node, POSITION position, const ServiceList &services, double timestamp) {
+	NS_LOG_FUNCTION(this << node << timestamp);
+	pthread_mutex_lock(&writer);
+	if(expiry > 0 && next.nodes.Find(node) < 0) {
+		wheel.Schedule(node, timestamp + expiry);
+	}
+	int slot = next.nodes.Add(node);
+	SetServices(slot, services);
+	next.nodes.SetLastSeen(slot, timestamp);
+	SetPosition(slot, position);
+	changed.push_back(node);
+	pthread_mutex_unlock(&writer);
+}
+
+/*
+ * Partial updates come from delta notifications and only apply to nodes the registry already knows,
+ * since a node without a position or without services can not be scheduled. They return false otherwise.
+ */
+bool NodeRegistry::UpdatePosition(uint node, POSITION position, double timestamp) {
+	NS_LOG_FUNCTION(this << node << timestamp);
+	pthread_mutex_lock(&writer);
+	int slot = next.nodes.Find(node);
+	if(slot >= 0) {
+		SetPosition(slot, position);
+		next.nodes.SetLastSeen(slot, timestamp);
+		changed.push_back(node);
+	}
+	pthread_mutex_unlock(&writer);
+	return slot >= 0;
+}
+
+bool NodeRegistry::UpdateServices(uint node, std::list<std::string> services, double timestamp) {
+	NS_LOG_FUNCTION(this << node << timestamp);
+	std::vector<int> serviceIds = ServiceCatalog::GetServiceIds(services);
+	std::vector<SERVICE_PATH> servicePaths;
+	ServicePath::Pack(services, servicePaths);
+	pthread_mutex_lock(&writer);
+	int slot = next.nodes.Find(node);
+	if(slot >= 0) {
+		SetServices(slot, services, serviceIds, servicePaths);
+		next.nodes.SetLastSeen(slot, timestamp);
+		changed.push_back(node);
+	}
+	pthread_mutex_unlock(&writer);
+	return slot >= 0;
+}
+
+bool NodeRegistry::UpdateServices(uint node, const ServiceList &services, double timestamp) {
+	NS_LOG_FUNCTION(this << node << timestamp);
+	pthread_mutex_lock(&writer);
+	int slot = next.nodes.Find(node);
+	if(slot >= 0) {
+		SetServices(slot, services);
+		next.nodes.SetLastSeen(slot, timestamp);
+		changed.push_back(node);
+	}
+	pthread_mutex_unlock(&writer);
+	return slot >= 0;
+}
+
+/*
+ * The speeds of the moving nodes are kept sorted, so the bound for how far any node may have moved
+ * since is the highest of them and drops again when that node slows down, stops or is evicted.
+ */
+bool NodeRegistry::UpdateMotion(uint node, MOTION motion) {
+	NS_LOG_FUNCTION(this << node);
+	double speed = GetSpeed(motion.velocity);
+	if(!(speed <= maxSpeed)) {
+		NS_LOG_WARN("Node " << node << " reported a speed of " << speed << "m/s, clamped to " << maxSpeed << "m/s");
+		if(speed < std::numeric_limits<double>::infinity()) {
+			motion.velocity.x *= maxSpeed / speed;
+			motion.velocity.y *= maxSpeed / speed;
+		} else {
+			motion.velocity.x = 0;
+			motion.velocity.y = 0;
+		}
+		speed = GetSpeed(motion.velocity);
+	}
+	pthread_mutex_lock(&writer);
+	int slot = next.nodes.Find(node);
+	if(slot >= 0) {
+		ForgetSpeed(slot);
+		next.nodes.SetMotion(slot, motion);
+		speeds.insert(speed);
+		next.maxSpeed = *speeds.rbegin();
+		changed.push_back(node);
+	}
+	pthread_mutex_unlock(&writer);
+	return slot >= 0;
+}
+
+void NodeRegistry::SetPosition(int slot, POSITION position) {
+	ForgetSpeed(slot);
+	next.nodes.SetPosition(slot, position);
+	if(spatialIndex) {
+		next.grid.Update(next.nodes.GetAddress(slot), position);
+	}
+}
+
+double NodeRegistry::GetSpeed(VELOCITY velocity) {
+	return sqrt(velocity.x * velocity.x + velocity.y * velocity.y);
+}
+
+/*
+ * A node that stops moving, or is about to go, no longer bounds how far the others may have moved.
+ */
+void NodeRegistry::ForgetSpeed(int slot) {
+	MOTION motion;
+	if(!next.nodes.GetMotion(slot, motion)) {
+		return;
+	}
+	speeds.erase(speeds.find(GetSpeed(motion.velocity)));
+	next.maxSpeed = speeds.empty() ? 0 : *speeds.rbegin();
+}
+
+/*
+ * Nodes are only on the wheel once, at the deadline they had when scheduled. Those heard from since
+ * are scheduled again at their current deadline instead of being evicted, so refreshing a node costs
+ * nothing. Evictions are staged like any other change and returned so the caller can publish them.
+ */
+int NodeRegistry::Expire(double now) {
+	NS_LOG_FUNCTION(this << now);
+	std::vector<uint> due;
+	int nEvicted = 0;
+	pthread_mutex_lock(&writer);
+	if(expiry <= 0) {
+		pthread_mutex_unlock(&writer);
+		return 0;
+	}
+	wheel.Advance(now, due);
+	for(uint i = 0; i < due.size(); i++) {
+		int slot = next.nodes.Find(due[i]);
+		if(slot < 0) {
+			continue;
+		}
+		double deadline = next.nodes.GetLastSeen(slot) + expiry;
+		if(deadline > now) {
+			wheel.Schedule(due[i], deadline);
+			continue;
+		}
+		ForgetSpeed(slot);
+		if(serviceIndex) {
+			int nPaths;
+			const SERVICE_PATH *paths = next.nodes.GetServicePaths(slot, nPaths);
+			next.services.Remove(due[i], paths, nPaths);
+		}
+		next.nodes.Remove(due[i]);
+		next.grid.Remove(due[i]);
+		changed.push_back(due[i]);
+		nEvicted++;
+		NS_LOG_DEBUG("Evicted node " << due[i] << " last seen at " << deadline - expiry);
+	}
+	evictions += nEvicted;
+	pthread_mutex_unlock(&writer);
+	return nEvicted;
+}
+
+/*
+ * Nodes notify the same services over and over, so the posting lists are only touched when they change.
+ */
+void NodeRegistry::SetServices(int slot, std::list<std::string> services, std::vector<int> serviceIds, std::vector<SERVICE_PATH> servicePaths) {
+	if(services == next.nodes.GetServices(slot)) {
+		return;
+	}
+	uint node = next.nodes.GetAddress(slot);
+	int nPaths;
+	const SERVICE_PATH *paths;
+	if(serviceIndex) {
+		paths = next.nodes.GetServicePaths(slot, nPaths);
+		next.services.Remove(node, paths, nPaths);
+	}
+	next.nodes.SetServices(slot, services, serviceIds, servicePaths);
+	if(serviceIndex) {
+		paths = next.nodes.GetServicePaths(slot, nPaths);
+		next.services.Add(node, paths, nPaths);
+	}
+}
+
+/*
+ * The ids decoded off the wire are stored as they are and catalog services take the paths packed with
+ * the catalog, so nothing is looked up by name. Names are only built when the services changed.
+ */
+void NodeRegistry::SetServices(int slot, const ServiceList &services) {
+	if(services.Equals(next.nodes.GetServices(slot))) {
+		return;
+	}
+	std::vector<SERVICE_PATH> servicePaths;
+	services.GetServicePaths(servicePaths);
+	SetServices(slot, services.GetServices(), services.GetServiceIds(), servicePaths);
+}
+
+/*
+ * Makes the node in the snapshot what it is in next, removing it if it is gone. Its posting lists are
+ * only touched when its services differ, and its cell only when it moved to another one.
+ */
+void NodeRegistry::CopyNode(REGISTRY_SNAPSHOT *snapshot, uint node) {
+	int slot = next.nodes.Find(node);
+	int copy = snapshot->nodes.Find(node);
+	bool servicesChanged = copy < 0 || slot < 0 || snapshot->nodes.GetServices(copy) != next.nodes.GetServices(slot);
+	int nPaths;
+	const SERVICE_PATH *paths;
+	if(serviceIndex && copy >= 0 && servicesChanged) {
+		paths = snapshot->nodes.GetServicePaths(copy, nPaths);
+		snapshot->services.Remove(node, paths, nPaths);
+	}
+	if(slot < 0) {
+		snapshot->nodes.Remove(node);
+		snapshot->grid.Remove(node);
+		return;
+	}
+	copy = snapshot->nodes.Copy(next.nodes, slot);
+	if(serviceIndex && servicesChanged) {
+		paths = snapshot->nodes.GetServicePaths(copy, nPaths);
+		snapshot->services.Add(node, paths, nPaths);
+	}
+	if(spatialIndex) {
+		snapshot->grid.Update(node, next.nodes.GetPosition(slot));
+	}
+}
+
+/*
+ * The spare snapshot was current until the previous publish, so it misses the changes published then
+ * as well as those staged since. Publishing costs a copy of the nodes changed, not of the registry.
+ */
+void NodeRegistry::Publish() {
+	NS_LOG_FUNCTION(this);
+	pthread_mutex_lock(&writer);
+	if(changed.empty()) {
+		pthread_mutex_unlock(&writer);
+		return;
+	}
+	next.version++;
+	std::vector<uint> missed(previousChanged);
+	missed.insert(missed.end(), changed.begin(), changed.end());
+	std::sort(missed.begin(), missed.end());
+	missed.erase(std::unique(missed.begin(), missed.end()), missed.end());
+	for(std::vector<uint>::iterator i = missed.begin(); i != missed.end(); i++) {
+		CopyNode(spare, *i);
+	}
+	spare->version = next.version;
+	spare->maxSpeed = next.maxSpeed;
+	previousChanged.swap(changed);
+	changed.clear();
+	REGISTRY_SNAPSHOT *snapshot = spare;
+	REGISTRY_SNAPSHOT *previous = current;
+	__sync_synchronize();
+	current = snapshot;
+	uint previousEpoch = __sync_fetch_and_add(&epoch, 1);
+	while(readers[previousEpoch & 1] > 0) {
+		sched_yield();
+	}
+	spare = previous;
+	NS_LOG_DEBUG("Published registry version " << snapshot->version << " with " << snapshot->nodes.GetSize() << " nodes, " << missed.size() << " of them copied");
+	pthread_mutex_unlock(&writer);
+}
+
+const REGISTRY_SNAPSHOT * NodeRegistry::Acquire(int &ticket) {
+	NS_LOG_FUNCTION(this);
+	while(true) {
+		uint pinnedEpoch = epoch;
+		ticket = pinnedEpoch & 1;
+		__sync_fetch_and_add(&readers[ticket], 1);
+		if(epoch == pinnedEpoch) {
+			break;
+		}
+		__sync_fetch_and_sub(&readers[ticket], 1);
+	}
+	return current;
+}
+
+void NodeRegistry::Release(int ticket) {
+	NS_LOG_FUNCTION(this << ticket);
+	__sync_fetch_and_sub(&readers[ticket], 1);
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+#ifndef NODE_REGISTRY_H
+#define NODE_REGISTRY_H
+
+#include <set>
+#include <list>
+#include <vector>
+#include <stdint.h>
+#include <pthread.h>
+
+#include "definitions.h"
+#include "grid-index.h"
+#include "node-table.h"
+#include "expiry-wheel.h"
+#include "service-list.h"
+#include "service-index.h"
+
+struct REGISTRY_SNAPSHOT {
+	uint64_t version;
+	double maxSpeed;
+	GridIndex grid;
+	NodeTable nodes;
+	ServiceIndex services;
+};
+
+class NodeRegistry {
+
+	public:
+		NodeRegistry();
+		~NodeRegistry();
+
+	private:
+		bool spatialIndex;
+		bool serviceIndex;
+		double expiry;
+		double maxSpeed;
+		uint64_t evictions;
+		ExpiryWheel wheel;
+		pthread_mutex_t writer;
+		REGISTRY_SNAPSHOT next;
+		std::multiset<double> speeds;
+		std::vector<uint> changed;
+		std::vector<uint> previousChanged;
+
+		volatile uint epoch;
+		volatile int readers[2];
+		REGISTRY_SNAPSHOT * volatile current;
+		REGISTRY_SNAPSHOT *spare;
+
+		void SetPosition(int slot, POSITION position);
+		void ForgetSpeed(int slot);
+		static double GetSpeed(VELOCITY velocity);
+		void SetServices(int slot, std::list<std::string> services, std::vector<int> serviceIds, std::vector<SERVICE_PATH> servicePaths);
+		void SetServices(int slot, const ServiceList &services);
+		void CopyNode(REGISTRY_SNAPSHOT *snapshot, uint node);
+
+	public:
+		void SetSpatialIndex(bool spatialIndex);
+		void SetServiceIndex(bool serviceIndex);
+		void SetExpiry(double expiry);
+		double GetExpiry() const;
+		void SetMaxSpeed(double maxSpeed);
+		uint64_t GetEvictions() const;
+		void Update(uint node, POSITION position, std::list<std::string> services, double timestamp);
+		void Update(uint node, POSITION position, const ServiceList &services, double timestamp);
+		bool UpdatePosition(uint node, POSITION position, double timestamp);
+		bool UpdateServices(uint node, std::list<std::string> services, double timestamp);
+		bool UpdateServices(uint node, const ServiceList &services, double timestamp);
+		bool UpdateMotion(uint node, MOTION motion);
+		int Expire(double now);
+		void Publish();
+
+		const REGISTRY_SNAPSHOT * Acquire(int &ticket);
+		void Release(int ticket);
+};
+
+#endif
\ No newline at end of file
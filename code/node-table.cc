@@ -0,0 +1,300 @@
+#include "node-table.h"
+
+#include "ns3/core-module.h"
+
+#include <cmath>
+#include <algorithm>
+
+#include "radius-filter.h"
+
+NS_LOG_COMPONENT_DEFINE("NodeTable");
+
+NodeTable::NodeTable() {
+	NS_LOG_FUNCTION(this);
+	nMotions = 0;
+	indexBits = 4;
+	index.resize(1 << indexBits, -1);
+}
+
+int NodeTable::GetHomeEntry(uint address) const {
+	return (address * 2654435761u) >> (32 - indexBits);
+}
+
+int NodeTable::FindEntry(uint address) const {
+	int mask = index.size() - 1;
+	for(int i = GetHomeEntry(address); index[i] >= 0; i = (i + 1) & mask) {
+		if(addresses[index[i]] == address) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+void NodeTable::Grow() {
+	NS_LOG_FUNCTION(this << index.size());
+	indexBits++;
+	index.assign(1 << indexBits, -1);
+	int mask = index.size() - 1;
+	for(uint slot = 0; slot < addresses.size(); slot++) {
+		int i = GetHomeEntry(addresses[slot]);
+		while(index[i] >= 0) {
+			i = (i + 1) & mask;
+		}
+		index[i] = slot;
+	}
+}
+
+void NodeTable::MoveSlot(int from, int to) {
+	addresses[to] = addresses[from];
+	x[to] = x[from];
+	y[to] = y[from];
+	velocityX[to] = velocityX[from];
+	velocityY[to] = velocityY[from];
+	motionTimestamps[to] = motionTimestamps[from];
+	moving[to] = moving[from];
+	lastSeen[to] = lastSeen[from];
+	nServiceIds[to] = nServiceIds[from];
+	nServicePaths[to] = nServicePaths[from];
+	std::copy(serviceIds.begin() + from * MAX_OFFERED_SERVICES, serviceIds.begin() + (from + 1) * MAX_OFFERED_SERVICES, serviceIds.begin() + to * MAX_OFFERED_SERVICES);
+	std::copy(servicePaths.begin() + from * MAX_OFFERED_SERVICES, servicePaths.begin() + (from + 1) * MAX_OFFERED_SERVICES, servicePaths.begin() + to * MAX_OFFERED_SERVICES);
+	services[to].swap(services[from]);
+}
+
+int NodeTable::GetSize() const {
+	return addresses.size();
+}
+
+int NodeTable::GetCapacity() const {
+	return index.size();
+}
+
+int NodeTable::Find(uint address) const {
+	int i = FindEntry(address);
+	return i < 0 ? -1 : index[i];
+}
+
+/*
+ * Returns the slot of the address, appending a node without services at the origin if there is none.
+ */
+int NodeTable::Add(uint address) {
+	int slot = Find(address);
+	if(slot >= 0) {
+		return slot;
+	}
+	//Kept at most half full, it is small next to the arrays it indexes
+	if((addresses.size() + 1) * 2 > index.size()) {
+		Grow();
+	}
+	slot = addresses.size();
+	int mask = index.size() - 1;
+	int i = GetHomeEntry(address);
+	while(index[i] >= 0) {
+		i = (i + 1) & mask;
+	}
+	index[i] = slot;
+	addresses.push_back(address);
+	x.push_back(0);
+	y.push_back(0);
+	velocityX.push_back(0);
+	velocityY.push_back(0);
+	motionTimestamps.push_back(0);
+	moving.push_back(false);
+	lastSeen.push_back(0);
+	nServiceIds.push_back(0);
+	nServicePaths.push_back(0);
+	serviceIds.resize(serviceIds.size() + MAX_OFFERED_SERVICES, UNKNOWN_SERVICE);
+	servicePaths.resize(servicePaths.size() + MAX_OFFERED_SERVICES, SERVICE_PATH());
+	services.push_back(std::list<std::string>());
+	NS_LOG_DEBUG("Node " << address << " added in slot " << slot);
+	return slot;
+}
+
+bool NodeTable::Remove(uint address) {
+	NS_LOG_FUNCTION(this << address);
+	int hole = FindEntry(address);
+	if(hole < 0) {
+		return false;
+	}
+	int slot = index[hole];
+	int last = addresses.size() - 1;
+	nMotions -= moving[slot];
+	if(slot != last) {
+		index[FindEntry(addresses[last])] = slot;
+		MoveSlot(last, slot);
+	}
+	int mask = index.size() - 1;
+	for(int i = (hole + 1) & mask; index[i] >= 0; i = (i + 1) & mask) {
+		//Entries whose home is not between the hole and them would become unreachable
+		int home = GetHomeEntry(addresses[index[i]]);
+		if(((i - home) & mask) >= ((i - hole) & mask)) {
+			index[hole] = index[i];
+			hole = i;
+		}
+	}
+	index[hole] = -1;
+	addresses.pop_back();
+	x.pop_back();
+	y.pop_back();
+	velocityX.pop_back();
+	velocityY.pop_back();
+	motionTimestamps.pop_back();
+	moving.pop_back();
+	lastSeen.pop_back();
+	nServiceIds.pop_back();
+	nServicePaths.pop_back();
+	serviceIds.resize(serviceIds.size() - MAX_OFFERED_SERVICES);
+	servicePaths.resize(servicePaths.size() - MAX_OFFERED_SERVICES);
+	services.pop_back();
+	return true;
+}
+
+/*
+ * Brings the node in slot of table over into this one, adding it if needed, and returns its slot here.
+ * Its names are only copied when they differ, which is seldom for a node that is just moving.
+ */
+int NodeTable::Copy(const NodeTable &table, int slot) {
+	int to = Add(table.addresses[slot]);
+	x[to] = table.x[slot];
+	y[to] = table.y[slot];
+	velocityX[to] = table.velocityX[slot];
+	velocityY[to] = table.velocityY[slot];
+	motionTimestamps[to] = table.motionTimestamps[slot];
+	nMotions += table.moving[slot] - moving[to];
+	moving[to] = table.moving[slot];
+	lastSeen[to] = table.lastSeen[slot];
+	nServiceIds[to] = table.nServiceIds[slot];
+	nServicePaths[to] = table.nServicePaths[slot];
+	std::copy(table.serviceIds.begin() + slot * MAX_OFFERED_SERVICES, table.serviceIds.begin() + (slot + 1) * MAX_OFFERED_SERVICES, serviceIds.begin() + to * MAX_OFFERED_SERVICES);
+	std::copy(table.servicePaths.begin() + slot * MAX_OFFERED_SERVICES, table.servicePaths.begin() + (slot + 1) * MAX_OFFERED_SERVICES, servicePaths.begin() + to * MAX_OFFERED_SERVICES);
+	if(services[to] != table.services[slot]) {
+		services[to] = table.services[slot];
+	}
+	return to;
+}
+
+uint NodeTable::GetAddress(int slot) const {
+	return addresses[slot];
+}
+
+POSITION NodeTable::GetPosition(int slot) const {
+	POSITION position;
+	position.x = x[slot];
+	position.y = y[slot];
+	return position;
+}
+
+/*
+ * A position without a motion is a node that stopped reporting its velocity, so its old one is dropped.
+ */
+void NodeTable::SetPosition(int slot, POSITION position) {
+	x[slot] = position.x;
+	y[slot] = position.y;
+	nMotions -= moving[slot];
+	moving[slot] = false;
+	velocityX[slot] = 0;
+	velocityY[slot] = 0;
+	motionTimestamps[slot] = 0;
+}
+
+bool NodeTable::GetMotion(int slot, MOTION &motion) const {
+	motion.velocity.x = velocityX[slot];
+	motion.velocity.y = velocityY[slot];
+	motion.timestamp = motionTimestamps[slot];
+	return moving[slot];
+}
+
+void NodeTable::SetMotion(int slot, MOTION motion) {
+	nMotions += !moving[slot];
+	moving[slot] = true;
+	velocityX[slot] = motion.velocity.x;
+	velocityY[slot] = motion.velocity.y;
+	motionTimestamps[slot] = motion.timestamp;
+}
+
+bool NodeTable::HasMotions() const {
+	return nMotions > 0;
+}
+
+double NodeTable::GetLastSeen(int slot) const {
+	return lastSeen[slot];
+}
+
+void NodeTable::SetLastSeen(int slot, double timestamp) {
+	lastSeen[slot] = timestamp;
+}
+
+const std::list<std::string> & NodeTable::GetServices(int slot) const {
+	return services[slot];
+}
+
+const int * NodeTable::GetServiceIds(int slot, int &nIds) const {
+	nIds = nServiceIds[slot];
+	return nIds < 0 ? NULL : &serviceIds[slot * MAX_OFFERED_SERVICES];
+}
+
+const SERVICE_PATH * NodeTable::GetServicePaths(int slot, int &nPaths) const {
+	nPaths = nServicePaths[slot];
+	return nPaths < 0 ? NULL : &servicePaths[slot * MAX_OFFERED_SERVICES];
+}
+
+void NodeTable::SetServices(int slot, std::list<std::string> services, std::vector<int> serviceIds, std::vector<SERVICE_PATH> servicePaths) {
+	this->services[slot] = services;
+	int nServices = services.size();
+	bool fits = nServices <= MAX_OFFERED_SERVICES;
+	if(fits && std::find(serviceIds.begin(), serviceIds.end(), UNKNOWN_SERVICE) == serviceIds.end()) {
+		std::copy(serviceIds.begin(), serviceIds.end(), this->serviceIds.begin() + slot * MAX_OFFERED_SERVICES);
+		nServiceIds[slot] = nServices;
+	} else {
+		nServiceIds[slot] = -1;
+	}
+	if(fits && (int) servicePaths.size() == nServices) {
+		std::copy(servicePaths.begin(), servicePaths.end(), this->servicePaths.begin() + slot * MAX_OFFERED_SERVICES);
+		nServicePaths[slot] = nServices;
+	} else {
+		nServicePaths[slot] = -1;
+	}
+}
+
+/*
+ * Timestamps are in milliseconds, and nodes are extrapolated up to MAX_PREDICTION_TIME either way.
+ */
+POSITION NodeTable::PredictPosition(int slot, double timestamp) const {
+	POSITION position = GetPosition(slot);
+	MOTION motion;
+	if(!GetMotion(slot, motion)) {
+		return position;
+	}
+	double elapsed = (timestamp - motion.timestamp) / 1000;
+	elapsed = std::max(-MAX_PREDICTION_TIME * 1.0, std::min(elapsed, MAX_PREDICTION_TIME * 1.0));
+	position.x += motion.velocity.x * elapsed;
+	position.y += motion.velocity.y * elapsed;
+	return position;
+}
+
+/*
+ * Appends the slots of the nodes whose predicted position is within radius of center. When some node
+ * moves, every position is predicted first; nodes without a motion have a zero velocity, so the
+ * prediction leaves them in place.
+ */
+void NodeTable::FilterInRange(POSITION center, double radius, double timestamp, std::vector<int> &slots) const {
+	NS_LOG_FUNCTION(this << radius << timestamp);
+	int size = addresses.size();
+	if(size == 0) {
+		return;
+	}
+	int first = slots.size();
+	slots.resize(first + size);
+	if(nMotions == 0) {
+		slots.resize(first + RadiusFilter::Filter(&x[0], &y[0], size, center, radius, &slots[first]));
+		return;
+	}
+	std::vector<double> predictedX(size);
+	std::vector<double> predictedY(size);
+	for(int slot = 0; slot < size; slot++) {
+		double elapsed = (timestamp - motionTimestamps[slot]) / 1000;
+		elapsed = std::max(-MAX_PREDICTION_TIME * 1.0, std::min(elapsed, MAX_PREDICTION_TIME * 1.0));
+		predictedX[slot] = x[slot] + velocityX[slot] * elapsed;
+		predictedY[slot] = y[slot] + velocityY[slot] * elapsed;
+	}
+	slots.resize(first + RadiusFilter::Filter(&predictedX[0], &predictedY[0], size, center, radius, &slots[first]));
+}
\ No newline at end of file
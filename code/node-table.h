@@ -0,0 +1,74 @@
+#ifndef NODE_TABLE_H
+#define NODE_TABLE_H
+
+#include <list>
+#include <string>
+#include <vector>
+
+#include "definitions.h"
+
+/*
+ * Nodes of the central registry as a structure of arrays: slot k of every array belongs to the
+ * node addresses[k], and an open addressing index maps addresses to slots. The radius filter only
+ * streams through the coordinate and motion arrays, and the offered services of a node sit in a
+ * fixed stride of MAX_OFFERED_SERVICES entries. Removing a node moves the last one into its slot,
+ * so slots are only stable until the next removal.
+ */
+class NodeTable {
+
+	public:
+		NodeTable();
+
+	private:
+		int indexBits;
+		std::vector<int> index;
+
+		std::vector<uint> addresses;
+		std::vector<double> x;
+		std::vector<double> y;
+		std::vector<double> velocityX;
+		std::vector<double> velocityY;
+		std::vector<double> motionTimestamps;
+		std::vector<char> moving;
+		std::vector<double> lastSeen;
+		int nMotions;
+
+		//Number of ids and paths of each node, -1 when some service is not in the catalog or can not be packed
+		std::vector<int> nServiceIds;
+		std::vector<int> serviceIds;
+		std::vector<int> nServicePaths;
+		std::vector<SERVICE_PATH> servicePaths;
+		std::vector<std::list<std::string> > services;
+
+		int GetHomeEntry(uint address) const;
+		int FindEntry(uint address) const;
+		void Grow();
+		void MoveSlot(int from, int to);
+
+	public:
+		int GetSize() const;
+		int GetCapacity() const;
+		int Find(uint address) const;
+		int Add(uint address);
+		bool Remove(uint address);
+		int Copy(const NodeTable &table, int slot);
+
+		uint GetAddress(int slot) const;
+		POSITION GetPosition(int slot) const;
+		void SetPosition(int slot, POSITION position);
+		bool GetMotion(int slot, MOTION &motion) const;
+		void SetMotion(int slot, MOTION motion);
+		bool HasMotions() const;
+		double GetLastSeen(int slot) const;
+		void SetLastSeen(int slot, double timestamp);
+
+		const std::list<std::string> & GetServices(int slot) const;
+		const int * GetServiceIds(int slot, int &nIds) const;
+		const SERVICE_PATH * GetServicePaths(int slot, int &nPaths) const;
+		void SetServices(int slot, std::list<std::string> services, std::vector<int> serviceIds, std::vector<SERVICE_PATH> servicePaths);
+
+		POSITION PredictPosition(int slot, double timestamp) const;
+		void FilterInRange(POSITION center, double radius, double timestamp, std::vector<int> &slots) const;
+};
+
+#endif
\ No newline at end of file
@@ -5,15 +5,12 @@
 #include <limits>
 
 #include "utilities.h"
+#include "service-path.h"
 
 NS_LOG_COMPONENT_DEFINE("OntologyApplication");
 
 NS_OBJECT_ENSURE_REGISTERED(OntologyApplication);
 
-const std::string OntologyApplication::SERVICES[] = {"0", "00", "000", "0000", "00000", "00001", "0001", "0002", "00020", "00021", "00022", "0003", "00030", "00031", "001", "0010", "00100", "0011", "00110", "00111", "01", "010", "0100", "01000", "0101", "01010", "01011", "01012", "01013", "011", "0110", "02", "020", "021", "022", "023"};
-
-const int OntologyApplication::TOTAL_NUMBER_OF_SERVICES = 35;
-
 TypeId OntologyApplication::GetTypeId() {
 	NS_LOG_FUNCTION_NOARGS();
 	static TypeId typeId = TypeId("OntologyApplication")
@@ -76,42 +73,23 @@ void OntologyApplication::StopApplication() {
 
 int OntologyApplication::SemanticDistance(std::string requiredService, std::string offeredService) {
 	NS_LOG_FUNCTION(requiredService << offeredService);
-	if(offeredService.compare(requiredService) == 0) {
-		NS_LOG_DEBUG(requiredService << " - " << offeredService << " = 0, they are the same service");
-		return 0;
-	}
-	std::string commonPrefix = GetCommonPrefix(requiredService, offeredService);
-	if(offeredService.compare(commonPrefix) == 0) {
-		NS_LOG_DEBUG(offeredService << " - " << commonPrefix << " = 0, " << offeredService << " is the first common ancestor with " << requiredService);
-		return 0;
-	}
-	int distanceFromOfferedToCommon = offeredService.length() - commonPrefix.length();
-	NS_LOG_DEBUG(offeredService << " - " << commonPrefix << " = " << distanceFromOfferedToCommon);
-	int distanceFromRequiredToCommon = requiredService.length() - commonPrefix.length();
-	NS_LOG_DEBUG(requiredService << " - " << commonPrefix << " = " << distanceFromRequiredToCommon);
-	NS_LOG_DEBUG(requiredService << " - " << offeredService << " = " << (distanceFromOfferedToCommon > distanceFromRequiredToCommon ? distanceFromOfferedToCommon : distanceFromRequiredToCommon));
-	return distanceFromOfferedToCommon > distanceFromRequiredToCommon ? distanceFromOfferedToCommon : distanceFromRequiredToCommon;
-}
-
-std::string OntologyApplication::GetCommonPrefix(std::string requiredService, std::string offeredService) {
-	NS_LOG_FUNCTION(requiredService << offeredService);
-	int minLength = requiredService.length() > offeredService.length() ? offeredService.length() : requiredService.length();
-	NS_LOG_INFO("Shorter string between " << requiredService << " and " << offeredService << " is " << (requiredService.length() > offeredService.length() ? offeredService : requiredService));
-	std::string commonPrefix;
-	for(int i = 0; i < minLength; i++) {
-		if(requiredService.at(i) == offeredService.at(i)) {
-			commonPrefix.push_back(requiredService.at(i));
-		} else {
-			break;
+	int requiredServiceId = ServiceCatalog::GetServiceId(requiredService);
+	int offeredServiceId = ServiceCatalog::GetServiceId(offeredService);
+	if(requiredServiceId == UNKNOWN_SERVICE || offeredServiceId == UNKNOWN_SERVICE) {
+		NS_LOG_DEBUG(requiredService << " - " << offeredService << " are not both in the catalog, calculating their distance");
+		SERVICE_PATH requiredPath;
+		SERVICE_PATH offeredPath;
+		if(ServicePath::Pack(requiredService, requiredPath) && ServicePath::Pack(offeredService, offeredPath)) {
+			return ServicePath::SemanticDistance(requiredPath, offeredPath);
 		}
+		return ServiceCatalog::CalculateSemanticDistance(requiredService, offeredService);
 	}
-	NS_LOG_DEBUG(requiredService << " and " << offeredService << " common prefix is " << commonPrefix);
-	return commonPrefix;
+	return ServiceCatalog::SemanticDistance(requiredServiceId, offeredServiceId);
 }
 
 std::string OntologyApplication::GetRandomService() {
 	NS_LOG_FUNCTION_NOARGS();
-	return SERVICES[(int) Utilities::Random(1, TOTAL_NUMBER_OF_SERVICES)];
+	return ServiceCatalog::GetService((int) Utilities::Random(1, ServiceCatalog::GetSize() - 1, STRATOS_ONTOLOGY_STREAM));
 }
 
 OFFERED_SERVICE OntologyApplication::GetBestOfferedService(std::string requiredService, std::list<std::string> offeredServices) {
@@ -137,6 +115,27 @@ OFFERED_SERVICE OntologyApplication::GetBestOfferedService(std::string requiredS
 	return result;
 }
 
+OFFERED_SERVICE OntologyApplication::GetBestOfferedService(int requiredService, const int *offeredServices, int nOfferedServices) {
+	NS_LOG_FUNCTION(requiredService << offeredServices << nOfferedServices);
+	int semanticDistance;
+	int bestOfferedService = UNKNOWN_SERVICE;
+	int minSemanticDistance = std::numeric_limits<int>::max();
+	for(int i = 0; i < nOfferedServices; i++) {
+		semanticDistance = ServiceCatalog::SemanticDistance(requiredService, offeredServices[i]);
+		if(semanticDistance < minSemanticDistance) {
+			bestOfferedService = offeredServices[i];
+			minSemanticDistance = semanticDistance;
+		}
+	}
+	OFFERED_SERVICE result;
+	if(bestOfferedService != UNKNOWN_SERVICE) {
+		result.service = ServiceCatalog::GetService(bestOfferedService);
+	}
+	result.semanticDistance = minSemanticDistance;
+	NS_LOG_DEBUG("Service " << result.service << " with semantic distance " << minSemanticDistance << " is the best option in list");
+	return result;
+}
+
 bool OntologyApplication::DoIProvideService(std::string service) {
 	NS_LOG_FUNCTION(this << service);
 	std::list<std::string>::iterator i;
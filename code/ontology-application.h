@@ -1,13 +1,18 @@
 #ifndef ONTOLOGY_APPLICATION_H
 #define ONTOLOGY_APPLICATION_H
 
+#include <vector>
+
 #include "definitions.h"
+#include "service-catalog.h"
 #include "application-helper.h"
 
 using namespace ns3;
 
 class OntologyApplication : public Application {
 
+	friend class KernelBenchmark;
+
 	public:
 		static TypeId GetTypeId();
 
@@ -23,18 +28,15 @@ class OntologyApplication : public Application {
 		virtual void StopApplication();
 
 	private:
-		static const std::string SERVICES[];
-		static const int TOTAL_NUMBER_OF_SERVICES;
-
 		int NUMBER_OF_SERVICES_OFFERED;
 		std::list<std::string> offeredServices;
 
 		static int SemanticDistance(std::string requiredService, std::string offeredService);
-		static std::string GetCommonPrefix(std::string requiredService, std::string offeredService);
 
 	public:
 		static std::string GetRandomService();
 		static OFFERED_SERVICE GetBestOfferedService(std::string requiredService, std::list<std::string> offeredServices);
+		static OFFERED_SERVICE GetBestOfferedService(int requiredService, const int *offeredServices, int nOfferedServices);
 
 		bool DoIProvideService(std::string service);
 		std::list<std::string> GetOfferedServices();
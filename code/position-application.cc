@@ -65,6 +65,16 @@ POSITION PositionApplication::GetCurrentPosition() {
 	return position;
 }
 
+VELOCITY PositionApplication::GetCurrentVelocity() {
+	NS_LOG_FUNCTION(this);
+	Vector rawVelocity = mobility->GetVelocity();
+	VELOCITY velocity;
+	velocity.x = rawVelocity.x;
+	velocity.y = rawVelocity.y;
+	NS_LOG_DEBUG(GetNode()->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal() << " -> current velocity is (" << velocity.x << ", " << velocity.y << ")");
+	return velocity;
+}
+
 PositionHelper::PositionHelper() {
 	NS_LOG_FUNCTION(this);
 	objectFactory.SetTypeId("PositionApplication");
@@ -31,6 +31,7 @@ class PositionApplication : public Application {
 		static double CalculateDistanceFromTo(POSITION from, POSITION to);
 
 		POSITION GetCurrentPosition();
+		VELOCITY GetCurrentVelocity();
 };
 
 class PositionHelper : public ApplicationHelper {
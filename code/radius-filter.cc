@@ -0,0 +1,154 @@
+#include "radius-filter.h"
+
+#include "ns3/core-module.h"
+
+#include <cmath>
+#include <limits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define RADIUS_FILTER_X86
+#include <immintrin.h>
+#endif
+
+NS_LOG_COMPONENT_DEFINE("RadiusFilter");
+
+RADIUS_FILTER RadiusFilter::filter = NULL;
+
+std::string RadiusFilter::instructionSet;
+
+pthread_once_t RadiusFilter::initialized = PTHREAD_ONCE_INIT;
+
+void RadiusFilter::Initialize() {
+	NS_LOG_FUNCTION_NOARGS();
+	filter = &RadiusFilter::FilterScalar;
+	instructionSet = "scalar";
+#ifdef RADIUS_FILTER_X86
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("avx2")) {
+		filter = &RadiusFilter::FilterAvx2;
+		instructionSet = "avx2";
+	} else if(__builtin_cpu_supports("sse2")) {
+		filter = &RadiusFilter::FilterSse2;
+		instructionSet = "sse2";
+	}
+#endif
+	NS_LOG_DEBUG("Radius filter uses " << instructionSet);
+}
+
+void RadiusFilter::EnsureInitialized() {
+	pthread_once(&initialized, &RadiusFilter::Initialize);
+}
+
+std::string RadiusFilter::GetInstructionSet() {
+	EnsureInitialized();
+	return instructionSet;
+}
+
+/*
+ * The root is monotonic, so the squares whose root is within the radius are all those up to some
+ * largest one. It is at most a few representable numbers away from radius * radius.
+ */
+double RadiusFilter::GetSquaredRadius(double radius) {
+	if(!(radius >= 0)) {
+		return -1;
+	}
+	double infinity = std::numeric_limits<double>::infinity();
+	double squaredRadius = radius * radius;
+	while(squaredRadius > 0 && sqrt(squaredRadius) > radius) {
+		squaredRadius = nextafter(squaredRadius, 0.0);
+	}
+	while(squaredRadius < infinity && sqrt(nextafter(squaredRadius, infinity)) <= radius) {
+		squaredRadius = nextafter(squaredRadius, infinity);
+	}
+	return squaredRadius;
+}
+
+int RadiusFilter::Filter(const double *x, const double *y, int n, POSITION center, double radius, int *indices) {
+	NS_LOG_FUNCTION(n << radius);
+	EnsureInitialized();
+	return filter(x, y, n, center.x, center.y, GetSquaredRadius(radius), indices);
+}
+
+/*
+ * Every index is written and the count only advances past the ones inside, so there are no branches.
+ * The vector implementations do the same a vector at a time and finish the block with this loop.
+ */
+int RadiusFilter::FilterFrom(int first, const double *x, const double *y, int n, double centerX, double centerY, double squaredRadius, int *indices, int count) {
+	for(int i = first; i < n; i++) {
+		double dx = centerX - x[i];
+		double dy = centerY - y[i];
+		indices[count] = i;
+		count += dx * dx + dy * dy <= squaredRadius;
+	}
+	return count;
+}
+
+int RadiusFilter::FilterScalar(const double *x, const double *y, int n, double centerX, double centerY, double squaredRadius, int *indices) {
+	return FilterFrom(0, x, y, n, centerX, centerY, squaredRadius, indices, 0);
+}
+
+#ifdef RADIUS_FILTER_X86
+
+int RadiusFilter::FilterSse2(const double *x, const double *y, int n, double centerX, double centerY, double squaredRadius, int *indices) {
+	__m128d cx = _mm_set1_pd(centerX);
+	__m128d cy = _mm_set1_pd(centerY);
+	__m128d r2 = _mm_set1_pd(squaredRadius);
+	int count = 0;
+	int i = 0;
+	for(; i + 2 <= n; i += 2) {
+		__m128d dx = _mm_sub_pd(cx, _mm_loadu_pd(x + i));
+		__m128d dy = _mm_sub_pd(cy, _mm_loadu_pd(y + i));
+		__m128d d2 = _mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy));
+		int mask = _mm_movemask_pd(_mm_cmple_pd(d2, r2));
+		indices[count] = i;
+		count += mask & 1;
+		indices[count] = i + 1;
+		count += mask >> 1;
+	}
+	return FilterFrom(i, x, y, n, centerX, centerY, squaredRadius, indices, count);
+}
+
+//Lanes set in each 4 bit mask, in order, and how many there are
+static const int COMPACT_LANES[16][4] = {
+	{0, 0, 0, 0}, {0, 0, 0, 0}, {1, 0, 0, 0}, {0, 1, 0, 0},
+	{2, 0, 0, 0}, {0, 2, 0, 0}, {1, 2, 0, 0}, {0, 1, 2, 0},
+	{3, 0, 0, 0}, {0, 3, 0, 0}, {1, 3, 0, 0}, {0, 1, 3, 0},
+	{2, 3, 0, 0}, {0, 2, 3, 0}, {1, 2, 3, 0}, {0, 1, 2, 3}
+};
+static const int COMPACT_COUNTS[16] = {0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4};
+
+/*
+ * Four points per iteration. The indices of the ones inside are packed with a lookup table and
+ * stored together; the store may write past them, but never past the index of the last point read.
+ * Multiplications and additions are kept separate, as in the scalar code, so no lane is fused.
+ */
+__attribute__((target("avx2")))
+int RadiusFilter::FilterAvx2(const double *x, const double *y, int n, double centerX, double centerY, double squaredRadius, int *indices) {
+	__m256d cx = _mm256_set1_pd(centerX);
+	__m256d cy = _mm256_set1_pd(centerY);
+	__m256d r2 = _mm256_set1_pd(squaredRadius);
+	int count = 0;
+	int i = 0;
+	for(; i + 4 <= n; i += 4) {
+		__m256d dx = _mm256_sub_pd(cx, _mm256_loadu_pd(x + i));
+		__m256d dy = _mm256_sub_pd(cy, _mm256_loadu_pd(y + i));
+		__m256d d2 = _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy));
+		int mask = _mm256_movemask_pd(_mm256_cmp_pd(d2, r2, _CMP_LE_OQ));
+		__m128i lanes = _mm_loadu_si128((const __m128i *) COMPACT_LANES[mask]);
+		_mm_storeu_si128((__m128i *) (indices + count), _mm_add_epi32(lanes, _mm_set1_epi32(i)));
+		count += COMPACT_COUNTS[mask];
+	}
+	return FilterFrom(i, x, y, n, centerX, centerY, squaredRadius, indices, count);
+}
+
+#else
+
+int RadiusFilter::FilterSse2(const double *x, const double *y, int n, double centerX, double centerY, double squaredRadius, int *indices) {
+	return FilterScalar(x, y, n, centerX, centerY, squaredRadius, indices);
+}
+
+int RadiusFilter::FilterAvx2(const double *x, const double *y, int n, double centerX, double centerY, double squaredRadius, int *indices) {
+	return FilterScalar(x, y, n, centerX, centerY, squaredRadius, indices);
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,40 @@
+#ifndef RADIUS_FILTER_H
+#define RADIUS_FILTER_H
+
+#include <string>
+#include <pthread.h>
+
+#include "definitions.h"
+
+typedef int (*RADIUS_FILTER)(const double *x, const double *y, int n, double centerX, double centerY, double squaredRadius, int *indices);
+
+/*
+ * Filters a block of coordinates against a circle, writing the indices of the points inside it in
+ * order and returning how many there are. The squared distances are compared against the largest
+ * square whose root is within the radius, so the result is exactly that of comparing the distances
+ * of PositionApplication::CalculateDistanceFromTo. The widest instruction set the CPU supports is
+ * picked once, by whichever thread uses the filter first.
+ */
+class RadiusFilter {
+
+	friend class Benchmark;
+
+	private:
+		static RADIUS_FILTER filter;
+		static std::string instructionSet;
+		static pthread_once_t initialized;
+
+		static void Initialize();
+		static void EnsureInitialized();
+		static int FilterFrom(int first, const double *x, const double *y, int n, double centerX, double centerY, double squaredRadius, int *indices, int count);
+		static int FilterScalar(const double *x, const double *y, int n, double centerX, double centerY, double squaredRadius, int *indices);
+		static int FilterSse2(const double *x, const double *y, int n, double centerX, double centerY, double squaredRadius, int *indices);
+		static int FilterAvx2(const double *x, const double *y, int n, double centerX, double centerY, double squaredRadius, int *indices);
+
+	public:
+		static std::string GetInstructionSet();
+		static double GetSquaredRadius(double radius);
+		static int Filter(const double *x, const double *y, int n, POSITION center, double radius, int *indices);
+};
+
+#endif
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include <limits>
 
 #include "utilities.h"
+#include "radius-filter.h"
 
 NS_LOG_COMPONENT_DEFINE("ResultsApplication");
 
@@ -45,6 +46,7 @@ void ResultsApplication::StartApplication() {
 	NS_LOG_FUNCTION(this);
 	active = false;
 	foundSomeone = 0;
+	providers.clear();
 	responseSemanticDistance = std::numeric_limits<int>::max();
 }
 
@@ -66,6 +68,10 @@ void ResultsApplication::StopApplication() {
 			}
 		}
 		NS_LOG_DEBUG(Ipv4Address(localAddress) << " -> results: \n\t elapsedTimeFromRequestResponseToFirstServiceResponse = " << elapsedTimeFromRequestResponseToFirstServiceResponse << "\n\t success = " << success << "\n\t foundSomeone = " << foundSomeone << "\n\t scheduleSize = " << scheduleSize << "\n\t nPackets = " << nPackets);
+		for(std::map<uint, PROVIDER_RESULT>::iterator i = providers.begin(); i != providers.end(); i++) {
+			PROVIDER_RESULT &provider = i->second;
+			NS_LOG_INFO(Ipv4Address(localAddress) << " -> provider " << Ipv4Address(i->first) << " sent " << provider.nPackets << " of " << provider.quota << " packets, first after " << (provider.nPackets > 0 ? provider.firstPacketTime - provider.startTime : -1) << "ms, last after " << (provider.nPackets > 0 ? provider.lastPacketTime - provider.startTime : -1) << "ms, session ended after " << (provider.endTime >= provider.startTime ? provider.endTime - provider.startTime : -1) << "ms");
+		}
 		std::cout << elapsedTimeFromRequestResponseToFirstServiceResponse << "|" << success << "|" << foundSomeone << "|" << scheduleSize << "|" << nPackets << std::endl;
 	}
 }
@@ -76,12 +82,51 @@ void ResultsApplication::Activate() {
 	NS_LOG_DEBUG(Ipv4Address(localAddress) << " -> results will be printed");
 }
 
-void ResultsApplication::AddPacket(double receiveTime) {
+void ResultsApplication::AddPacket(double receiveTime, uint providerAddress) {
 	NS_LOG_FUNCTION(this);
 	pthread_mutex_lock(&mutex);
 	packetsTimes.push_back(receiveTime);
+	std::map<uint, PROVIDER_RESULT>::iterator provider = providers.find(providerAddress);
+	if(provider != providers.end()) {
+		if(provider->second.nPackets == 0) {
+			provider->second.firstPacketTime = receiveTime;
+		}
+		provider->second.lastPacketTime = receiveTime;
+		provider->second.nPackets++;
+	}
 	pthread_mutex_unlock(&mutex);
-	NS_LOG_DEBUG(Ipv4Address(localAddress) << " -> received service packet at " << receiveTime);
+	NS_LOG_DEBUG(Ipv4Address(localAddress) << " -> received service packet from " << Ipv4Address(providerAddress) << " at " << receiveTime);
+}
+
+void ResultsApplication::AddProviderQuota(uint providerAddress, int packets) {
+	NS_LOG_FUNCTION(this);
+	std::map<uint, PROVIDER_RESULT>::iterator provider = providers.find(providerAddress);
+	if(provider != providers.end()) {
+		provider->second.quota += packets;
+		NS_LOG_DEBUG(Ipv4Address(localAddress) << " -> provider " << Ipv4Address(providerAddress) << " has to send " << packets << " more packets");
+	}
+}
+
+void ResultsApplication::StartProvider(uint providerAddress, int quota, double startTime) {
+	NS_LOG_FUNCTION(this);
+	PROVIDER_RESULT provider;
+	provider.quota = quota;
+	provider.nPackets = 0;
+	provider.startTime = startTime;
+	provider.firstPacketTime = -1;
+	provider.lastPacketTime = -1;
+	provider.endTime = -1;
+	providers[providerAddress] = provider;
+	NS_LOG_DEBUG(Ipv4Address(localAddress) << " -> provider " << Ipv4Address(providerAddress) << " contacted at " << startTime << " for " << quota << " packets");
+}
+
+void ResultsApplication::FinishProvider(uint providerAddress, double endTime) {
+	NS_LOG_FUNCTION(this);
+	std::map<uint, PROVIDER_RESULT>::iterator provider = providers.find(providerAddress);
+	if(provider != providers.end()) {
+		provider->second.endTime = endTime;
+		NS_LOG_DEBUG(Ipv4Address(localAddress) << " -> provider " << Ipv4Address(providerAddress) << " finished at " << endTime);
+	}
 }
 
 void ResultsApplication::SetScheduleSize(int scheduleSize) {
@@ -114,14 +159,6 @@ void ResultsApplication::SetRequestService(std::string requestService) {
 	NS_LOG_DEBUG(Ipv4Address(localAddress) << " -> requested service was " << requestService);
 }
 
-void ResultsApplication::EvaluateNode(Ptr<ResultsApplication> requester) {
-	NS_LOG_FUNCTION(this);
-	POSITION position = positionManager->GetCurrentPosition();
-	std::list<std::string> services = ontologyManager->GetOfferedServices();
-	NS_LOG_DEBUG(Ipv4Address(localAddress) << " -> calling " << requester->GetNode()->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal() << " to evaluate me");
-	requester->Evaluate(localAddress, position, services);
-}
-
 void ResultsApplication::SetResponseSemanticDistance(int responseSemanticDistance) {
 	NS_LOG_FUNCTION(this);
 	foundSomeone = 1;
@@ -129,20 +166,38 @@ void ResultsApplication::SetResponseSemanticDistance(int responseSemanticDistanc
 	NS_LOG_DEBUG(Ipv4Address(localAddress) << " -> requested service was " << requestService);
 }
 
-void ResultsApplication::Evaluate(uint nodeAddress, POSITION nodePosition, std::list<std::string> nodeServices) {
+/*
+ * Ground truth of a request, evaluated in a single event right after the request is sent, with every node
+ * where it is at that moment. Positions are gathered first, so the nodes in the area of interest are found
+ * in one pass of RadiusFilter, and services are only looked at for them.
+ */
+void ResultsApplication::EvaluateNodes(std::vector<Ptr<ResultsApplication> > nodes) {
 	NS_LOG_FUNCTION(this);
-	if(localAddress == nodeAddress) {
-		NS_LOG_DEBUG(Ipv4Address(localAddress) << " -> won't evaluate myself");
+	if(nodes.empty()) {
 		return;
 	}
-	double distance = PositionApplication::CalculateDistanceFromTo(nodePosition, requestPosition);
-	if(distance > requestDistance) {
-		NS_LOG_DEBUG(Ipv4Address(localAddress) << " -> " << Ipv4Address(nodeAddress) << " is not in the area of interes");
-		return;
+	int nNodes = nodes.size();
+	std::vector<double> x(nNodes);
+	std::vector<double> y(nNodes);
+	for(int k = 0; k < nNodes; k++) {
+		POSITION position = nodes[k]->positionManager->GetCurrentPosition();
+		x[k] = position.x;
+		y[k] = position.y;
+	}
+	std::vector<int> inRange(nNodes);
+	inRange.resize(RadiusFilter::Filter(&x[0], &y[0], nNodes, requestPosition, requestDistance, &inRange[0]));
+	NS_LOG_DEBUG(Ipv4Address(localAddress) << " -> " << inRange.size() << " of " << nNodes << " nodes are in the area of interest");
+	for(std::vector<int>::iterator k = inRange.begin(); k != inRange.end(); k++) {
+		Ptr<ResultsApplication> node = nodes[*k];
+		uint nodeAddress = node->localAddress;
+		if(localAddress == nodeAddress) {
+			NS_LOG_DEBUG(Ipv4Address(localAddress) << " -> won't evaluate myself");
+			continue;
+		}
+		OFFERED_SERVICE service = node->ontologyManager->GetBestOfferedService(requestService);
+		semanticDistances[nodeAddress] = service.semanticDistance;
+		NS_LOG_DEBUG(Ipv4Address(localAddress) << " -> " << Ipv4Address(nodeAddress) << " best provided service for " << requestService << " is " << service.service << " with " << service.semanticDistance << " semantic distance");
 	}
-	OFFERED_SERVICE service = OntologyApplication::GetBestOfferedService(requestService, nodeServices);
-	semanticDistances[nodeAddress] = service.semanticDistance;
-	NS_LOG_DEBUG(Ipv4Address(localAddress) << " -> " << Ipv4Address(nodeAddress) << " best provided service for " << requestService << " is " << service.service << " with " << service.semanticDistance << " semantic distance");
 }
 
 ResultsHelper::ResultsHelper() {
@@ -2,6 +2,7 @@
 #define RESULTS_APPLICATION_H
 
 #include <map>
+#include <vector>
 #include <pthread.h>
 
 #include "definitions.h"
@@ -40,20 +41,23 @@ class ResultsApplication : public Application {
 		int responseSemanticDistance;
 		std::list<double> packetsTimes;
 		std::map<uint, int> semanticDistances;
+		std::map<uint, PROVIDER_RESULT> providers;
 		Ptr<PositionApplication> positionManager;
 		Ptr<OntologyApplication> ontologyManager;
 
 	public:
 		void Activate();
-		void AddPacket(double receiveTime);
+		void AddPacket(double receiveTime, uint providerAddress);
+		void AddProviderQuota(uint providerAddress, int packets);
+		void StartProvider(uint providerAddress, int quota, double startTime);
+		void FinishProvider(uint providerAddress, double endTime);
 		void SetScheduleSize(int scheduleSize);
 		void SetRequestTime(double requestTime);
 		void SetRequestDistance(double requestDistance);
 		void SetRequestPosition(POSITION requestPosition);
 		void SetRequestService(std::string requestService);
-		void EvaluateNode(Ptr<ResultsApplication> requester);
 		void SetResponseSemanticDistance(int responseSemanticDistance);
-		void Evaluate(uint nodeAddress, POSITION nodePosition, std::list<std::string> nodeServices);
+		void EvaluateNodes(std::vector<Ptr<ResultsApplication> > nodes);
 };
 
 class ResultsHelper : public ApplicationHelper {
@@ -0,0 +1,98 @@
+#include "retransmission-timer.h"
+
+#include "ns3/core-module.h"
+
+#include <cmath>
+#include <algorithm>
+
+NS_LOG_COMPONENT_DEFINE("RetransmissionTimer");
+
+RetransmissionTimer::RetransmissionTimer() {
+	NS_LOG_FUNCTION(this);
+	adaptive = false;
+	nRetransmits = 0;
+	nSpuriousRetransmits = 0;
+}
+
+void RetransmissionTimer::SetAdaptive(bool adaptive) {
+	NS_LOG_FUNCTION(this << adaptive);
+	this->adaptive = adaptive;
+}
+
+double RetransmissionTimer::GetTimeout(uint peer, int nRetransmits) {
+	NS_LOG_FUNCTION(this << peer << nRetransmits);
+	if(!adaptive) {
+		return MAX_RESPONSE_WAIT_TIME;
+	}
+	double timeout = MAX_RESPONSE_WAIT_TIME;
+	std::map<uint, RTT_ESTIMATE>::iterator estimate = estimates.find(peer);
+	if(estimate != estimates.end()) {
+		timeout = estimate->second.srtt + 4 * estimate->second.rttvar;
+	}
+	timeout = std::max(timeout, (double) MIN_RETRANSMISSION_TIMEOUT) * std::pow(2.0, nRetransmits);
+	return std::min(timeout, (double) MAX_RETRANSMISSION_TIMEOUT);
+}
+
+double RetransmissionTimer::GetExpirationTime(uint peer) {
+	NS_LOG_FUNCTION(this << peer);
+	double expirationTime = 0;
+	for(int i = 0; i <= MAX_TRIES; i++) {
+		expirationTime += GetTimeout(peer, i);
+	}
+	return expirationTime;
+}
+
+void RetransmissionTimer::AddSample(uint peer, double rtt) {
+	NS_LOG_FUNCTION(this << peer << rtt);
+	std::map<uint, RTT_ESTIMATE>::iterator estimate = estimates.find(peer);
+	if(estimate == estimates.end()) {
+		RTT_ESTIMATE first;
+		first.srtt = rtt;
+		first.rttvar = rtt / 2;
+		first.minRtt = rtt;
+		estimates[peer] = first;
+	} else {
+		estimate->second.rttvar = 0.75 * estimate->second.rttvar + 0.25 * std::fabs(estimate->second.srtt - rtt);
+		estimate->second.srtt = 0.875 * estimate->second.srtt + 0.125 * rtt;
+		estimate->second.minRtt = std::min(estimate->second.minRtt, rtt);
+	}
+	NS_LOG_DEBUG("RTT to " << peer << " is " << estimates[peer].srtt << "s +- " << estimates[peer].rttvar << "s");
+}
+
+TRANSMISSION RetransmissionTimer::Send() {
+	NS_LOG_FUNCTION(this);
+	TRANSMISSION transmission;
+	transmission.firstTime = ns3::Now().GetSeconds();
+	transmission.lastTime = transmission.firstTime;
+	transmission.nRetransmits = 0;
+	return transmission;
+}
+
+void RetransmissionTimer::Retransmit(TRANSMISSION &transmission) {
+	NS_LOG_FUNCTION(this);
+	transmission.lastTime = ns3::Now().GetSeconds();
+	transmission.nRetransmits++;
+	nRetransmits++;
+}
+
+void RetransmissionTimer::Acknowledge(uint peer, TRANSMISSION transmission) {
+	NS_LOG_FUNCTION(this << peer);
+	double now = ns3::Now().GetSeconds();
+	if(transmission.nRetransmits == 0) {
+		AddSample(peer, now - transmission.firstTime);
+		return;
+	}
+	std::map<uint, RTT_ESTIMATE>::iterator estimate = estimates.find(peer);
+	if(estimate != estimates.end() && now - transmission.lastTime < estimate->second.minRtt) {
+		NS_LOG_DEBUG("Retransmission to " << peer << " was spurious, answer arrived " << (now - transmission.lastTime) << "s after it");
+		nSpuriousRetransmits++;
+	}
+}
+
+int RetransmissionTimer::GetRetransmits() {
+	return nRetransmits;
+}
+
+int RetransmissionTimer::GetSpuriousRetransmits() {
+	return nSpuriousRetransmits;
+}
\ No newline at end of file
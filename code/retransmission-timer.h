@@ -0,0 +1,39 @@
+#ifndef RETRANSMISSION_TIMER_H
+#define RETRANSMISSION_TIMER_H
+
+#include <map>
+
+#include "definitions.h"
+
+/*
+ * Per peer retransmission timeouts from smoothed RTT and RTT variation (Jacobson/Karels),
+ * doubled on every retry. Only answers to messages sent once are sampled (Karn), and a
+ * retransmission is spurious when its answer arrives sooner than the peer's minimum RTT.
+ */
+class RetransmissionTimer {
+
+	public:
+		RetransmissionTimer();
+
+	private:
+		bool adaptive;
+		int nRetransmits;
+		int nSpuriousRetransmits;
+		std::map<uint, RTT_ESTIMATE> estimates;
+
+		void AddSample(uint peer, double rtt);
+
+	public:
+		void SetAdaptive(bool adaptive);
+		double GetTimeout(uint peer, int nRetransmits);
+		double GetExpirationTime(uint peer);
+
+		TRANSMISSION Send();
+		void Retransmit(TRANSMISSION &transmission);
+		void Acknowledge(uint peer, TRANSMISSION transmission);
+
+		int GetRetransmits();
+		int GetSpuriousRetransmits();
+};
+
+#endif
\ No newline at end of file
@@ -3,6 +3,8 @@
 #include "ns3/core-module.h"
 #include "ns3/internet-module.h"
 
+#include <algorithm>
+
 #include "search-application.h"
 
 NS_LOG_COMPONENT_DEFINE("ScheduleApplication");
@@ -18,7 +20,12 @@ TypeId ScheduleApplication::GetTypeId() {
  						"Max number of nodes in a schedule.",
  						IntegerValue(3),
  						MakeIntegerAccessor(&ScheduleApplication::MAX_SCHEDULE_SIZE),
- 						MakeIntegerChecker<int>());
+ 						MakeIntegerChecker<int>())
+		.AddAttribute("parallel",
+						"Contact all the nodes in a schedule at once and split the packets among them.",
+						BooleanValue(false),
+						MakeBooleanAccessor(&ScheduleApplication::PARALLEL_SCHEDULE),
+						MakeBooleanChecker());
 	return typeId;
 }
 
@@ -62,10 +69,78 @@ void ScheduleApplication::ExecuteSchedule() {
 	int requestExtraPackets = serviceManager->NUMBER_OF_PACKETS_TO_SEND % schedule.size();
 	NS_LOG_DEBUG(GetNode()->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal() << " -> there are " << requestExtraPackets << " packets that will be added to this request to fill the " << serviceManager->NUMBER_OF_PACKETS_TO_SEND << " total packages needed");
 	schedule.pop_front();
-	serviceManager->SetCallback(MakeCallback(&ScheduleApplication::ContinueSchedule, this));
+	serviceManager->SetCallback(MakeCallback(&ScheduleApplication::FinishService, this));
+	resultsManager->StartProvider(node.GetResponseAddress().Get(), packetsByNode + requestExtraPackets, Now().GetMilliSeconds());
 	serviceManager->CreateAndSendRequest(node.GetResponseAddress(), node.GetOfferedService().service,packetsByNode + requestExtraPackets);
 }
 
+void ScheduleApplication::ExecuteScheduleInParallel() {
+	NS_LOG_FUNCTION(this);
+	int nPackets = serviceManager->NUMBER_OF_PACKETS_TO_SEND;
+	int nProviders = schedule.size();
+	quotas.clear();
+	services.clear();
+	serviceManager->SetCallback(MakeCallback(&ScheduleApplication::FinishService, this));
+	for(int i = 0; !schedule.empty(); i++) {
+		SearchResponseHeader node = schedule.front();
+		schedule.pop_front();
+		int quota = nPackets / nProviders + (i < nPackets % nProviders ? 1 : 0);
+		if(quota == 0) {
+			NS_LOG_DEBUG(GetNode()->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal() << " -> no packets left for " << node.GetResponseAddress());
+			continue;
+		}
+		uint address = node.GetResponseAddress().Get();
+		quotas[address] = quota;
+		services[address] = node.GetOfferedService().service;
+		NS_LOG_DEBUG(GetNode()->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal() << " -> requesting " << quota << " packets to " << node);
+		resultsManager->StartProvider(address, quota, Now().GetMilliSeconds());
+		serviceManager->CreateAndSendRequest(node.GetResponseAddress(), services[address], quota);
+	}
+}
+
+void ScheduleApplication::FinishService(Ipv4Address provider, int receivedPackets) {
+	NS_LOG_FUNCTION(this << provider << receivedPackets);
+	resultsManager->FinishProvider(provider.Get(), Now().GetMilliSeconds());
+	if(!PARALLEL_SCHEDULE) {
+		ContinueSchedule();
+		return;
+	}
+	std::map<uint, int>::iterator quota = quotas.find(provider.Get());
+	if(quota == quotas.end()) {
+		NS_LOG_DEBUG(GetNode()->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal() << " -> " << provider << " is not in the running schedule");
+		return;
+	}
+	int missingPackets = quota->second - receivedPackets;
+	quotas.erase(quota);
+	services.erase(provider.Get());
+	NS_LOG_DEBUG(GetNode()->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal() << " -> " << provider << " finished with " << receivedPackets << " packets received");
+	if(missingPackets > 0) {
+		ReassignPackets(missingPackets);
+	}
+}
+
+void ScheduleApplication::ReassignPackets(int packets) {
+	NS_LOG_FUNCTION(this << packets);
+	bool assigned = true;
+	while(packets > 0 && assigned) {
+		assigned = false;
+		int share = (packets + quotas.size() - 1) / std::max((int) quotas.size(), 1);
+		for(std::map<uint, int>::iterator i = quotas.begin(); i != quotas.end() && packets > 0; i++) {
+			int extraPackets = std::min(share, packets);
+			if(serviceManager->AddPackets(Ipv4Address(i->first), services[i->first], extraPackets)) {
+				NS_LOG_DEBUG(GetNode()->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal() << " -> " << extraPackets << " packets reassigned to " << Ipv4Address(i->first));
+				resultsManager->AddProviderQuota(i->first, extraPackets);
+				i->second += extraPackets;
+				packets -= extraPackets;
+				assigned = true;
+			}
+		}
+	}
+	if(packets > 0) {
+		NS_LOG_DEBUG(GetNode()->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal() << " -> no node left in schedule to send " << packets << " packets");
+	}
+}
+
 void ScheduleApplication::CreateSchedule(std::list<SearchResponseHeader> responses) {
 	NS_LOG_FUNCTION(this << &responses);
 	scheduleSize = 1;
@@ -110,6 +185,7 @@ void ScheduleApplication::ContinueSchedule() {
 		SearchResponseHeader node = schedule.front();
 		NS_LOG_DEBUG(GetNode()->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal() << " -> next node in schedule is " << node);
 		schedule.pop_front();
+		resultsManager->StartProvider(node.GetResponseAddress().Get(), packetsByNode, Now().GetMilliSeconds());
 		serviceManager->CreateAndSendRequest(node.GetResponseAddress(), node.GetOfferedService().service, packetsByNode);
 		return;
 	}
@@ -119,7 +195,11 @@ void ScheduleApplication::ContinueSchedule() {
 void ScheduleApplication::CreateAndExecuteSchedule(std::list<SearchResponseHeader> responses) {
 	NS_LOG_FUNCTION(this << &responses);
 	CreateSchedule(responses);
-	ExecuteSchedule();
+	if(PARALLEL_SCHEDULE) {
+		ExecuteScheduleInParallel();
+	} else {
+		ExecuteSchedule();
+	}
 }
 
 ScheduleHelper::ScheduleHelper() {
@@ -15,6 +15,8 @@ class ServiceApplication;
 
 class ScheduleApplication : public Application {
 
+	friend class KernelBenchmark;
+
 	public:
 		static TypeId GetTypeId();
 
@@ -32,6 +34,8 @@ class ScheduleApplication : public Application {
 	private:
 		int scheduleSize;
 		int packetsByNode;
+		std::map<uint, int> quotas;
+		std::map<uint, std::string> services;
 		Ptr<ResultsApplication> resultsManager;
 		Ptr<ServiceApplication> serviceManager;
 		std::list<SearchResponseHeader> schedule;
@@ -39,10 +43,14 @@ class ScheduleApplication : public Application {
 		static std::list<SearchResponseHeader> DeleteElement(std::list<SearchResponseHeader> list, SearchResponseHeader element);
 
 		void ExecuteSchedule();
+		void ExecuteScheduleInParallel();
+		void ReassignPackets(int packets);
+		void FinishService(Ipv4Address provider, int receivedPackets);
 		void CreateSchedule(std::list<SearchResponseHeader> responses);
 
 	public:
 		int MAX_SCHEDULE_SIZE;
+		bool PARALLEL_SCHEDULE;
 
 		void ContinueSchedule();
 		void CreateAndExecuteSchedule(std::list<SearchResponseHeader> responses);
@@ -17,7 +17,32 @@ TypeId SearchApplication::GetTypeId() {
 						"Address of the central server.",
 						UintegerValue(Ipv4Address("255.255.255.255").Get()),
 						MakeUintegerAccessor(&SearchApplication::centralServerAddress),
-						MakeUintegerChecker<uint>());
+						MakeUintegerChecker<uint>())
+		.AddAttribute("adaptiveTimers",
+						"Derive retry timeouts from the measured RTT to the central server instead of a fixed wait.",
+						BooleanValue(false),
+						MakeBooleanAccessor(&SearchApplication::ADAPTIVE_TIMERS),
+						MakeBooleanChecker())
+		.AddAttribute("deltaNotifications",
+						"Notify the central only when the node moved or its services changed, sending just the changed fields.",
+						BooleanValue(false),
+						MakeBooleanAccessor(&SearchApplication::DELTA_NOTIFICATIONS),
+						MakeBooleanChecker())
+		.AddAttribute("velocityNotifications",
+						"Add the current velocity and a timestamp to notifications so the central can predict positions.",
+						BooleanValue(false),
+						MakeBooleanAccessor(&SearchApplication::VELOCITY_NOTIFICATIONS),
+						MakeBooleanChecker())
+		.AddAttribute("notificationDistance",
+						"Distance in meters a node has to move before notifying its new position.",
+						DoubleValue(NOTIFICATION_DISTANCE),
+						MakeDoubleAccessor(&SearchApplication::NOTIFICATION_DISTANCE_THRESHOLD),
+						MakeDoubleChecker<double>(0))
+		.AddAttribute("keepaliveTime",
+						"Seconds after which a node notifies all its fields even if nothing changed.",
+						DoubleValue(KEEPALIVE_TIME),
+						MakeDoubleAccessor(&SearchApplication::KEEPALIVE_INTERVAL),
+						MakeDoubleChecker<double>(HELLO_TIME));
 	return typeId;
 }
 
@@ -32,6 +57,13 @@ SearchApplication::~SearchApplication() {
 void SearchApplication::DoInitialize() {
 	NS_LOG_FUNCTION(this);
 	response = false;
+	notified = false;
+	lastNotificationTime = 0;
+	lastNotifiedPosition.x = 0;
+	lastNotifiedPosition.y = 0;
+	notificationBytes = 0;
+	periodicNotificationBytes = 0;
+	retransmissionTimer.SetAdaptive(ADAPTIVE_TIMERS);
 	serviceManager = DynamicCast<ServiceApplication>(GetNode()->GetApplication(3));
 	resultsManager = DynamicCast<ResultsApplication>(GetNode()->GetApplication(4));
 	ontologyManager = DynamicCast<OntologyApplication>(GetNode()->GetApplication(0));
@@ -56,7 +88,7 @@ void SearchApplication::DoDispose() {
 void SearchApplication::StartApplication() {
 	NS_LOG_FUNCTION(this);
 	socket->SetRecvCallback(MakeCallback(&SearchApplication::ReceiveMessage, this));
-	Simulator::Schedule(Seconds(Utilities::Random(0, HELLO_TIME)), &SearchApplication::CreateAndSendNotification, this);
+	Simulator::Schedule(Seconds(Utilities::Random(0, HELLO_TIME, STRATOS_JITTER_STREAM)), &SearchApplication::CreateAndSendNotification, this);
 }
 
 void SearchApplication::StopApplication() {
@@ -64,6 +96,8 @@ void SearchApplication::StopApplication() {
 	if(socket != NULL) {
 		socket->SetRecvCallback(MakeNullCallback<void, Ptr<Socket> >());
 	}
+	NS_LOG_INFO(localAddress << " -> " << notificationBytes << " notification bytes sent, " << GetNotificationBytesSaved() << " saved over periodic notifications");
+	NS_LOG_INFO(localAddress << " -> " << retransmissionTimer.GetRetransmits() << " request retransmits, " << retransmissionTimer.GetSpuriousRetransmits() << " spurious and " << (retransmissionTimer.GetRetransmits() - retransmissionTimer.GetSpuriousRetransmits()) << " genuine");
 }
 
 SearchResponseHeader SearchApplication::SelectBestResponse(std::list<SearchResponseHeader> responses) {
@@ -100,6 +134,11 @@ void SearchApplication::CreateAndSendRequest() {
 	resultsManager->SetRequestDistance(request.GetMaxDistanceAllowed());
 }
 
+double SearchApplication::GetNotificationBytesSaved() {
+	NS_LOG_FUNCTION(this);
+	return periodicNotificationBytes - notificationBytes;
+}
+
 void SearchApplication::ReceiveMessage(Ptr<Socket> socket) {
 	NS_LOG_FUNCTION(this << socket);
 	Ptr<Packet> packet = socket->Recv();
@@ -150,8 +189,9 @@ void SearchApplication::SendRequest(SearchRequestHeader requestHeader) {
 	packet->AddHeader(typeHeader);
 	NS_LOG_DEBUG(localAddress << " -> Schedule request to send");
 	Simulator::Schedule(Seconds(Utilities::GetJitter()), &SearchApplication::SendUnicastMessage, this, packet, centralServerAddress);
+	transmissions[GetRequestKey(requestHeader)] = retransmissionTimer.Send();
 	NS_LOG_DEBUG(localAddress << " -> Schedule request to retry");
-	timers[GetRequestKey(requestHeader)] = Simulator::Schedule(Seconds(MAX_RESPONSE_WAIT_TIME + Utilities::GetJitter()), &SearchApplication::RetryRequest, this, packet, 1, GetRequestKey(requestHeader));
+	timers[GetRequestKey(requestHeader)] = Simulator::Schedule(Seconds(retransmissionTimer.GetTimeout(centralServerAddress, 0) + Utilities::GetJitter()), &SearchApplication::RetryRequest, this, packet, 1, GetRequestKey(requestHeader));
 }
 
 std::pair<uint, double> SearchApplication::GetRequestKey(SearchRequestHeader request) {
@@ -166,7 +206,8 @@ void SearchApplication::ReceiveError(Ptr<Packet> packet) {
 	NS_LOG_FUNCTION(this << packet);
 	SearchErrorHeader errorHeader;
 	packet->RemoveHeader(errorHeader);
-	Simulator::Cancel(timers[GetRequestKey(errorHeader)]);
+	AcknowledgeRequest(GetRequestKey(errorHeader));
+	CancelRequest(GetRequestKey(errorHeader));
 	NS_LOG_DEBUG(localAddress << " -> There is no response for request: " << errorHeader);
 }
 
@@ -183,8 +224,35 @@ void SearchApplication::RetryRequest(Ptr<Packet> packet, int nTry, std::pair<uin
 	if (nTry <= MAX_TRIES) {
 		NS_LOG_DEBUG(localAddress << " -> Retrying request (" << nTry << ")");
 		Simulator::Schedule(Seconds(Utilities::GetJitter()), &SearchApplication::SendUnicastMessage, this, packet, centralServerAddress);
+		std::map<std::pair<uint, double>, TRANSMISSION>::iterator transmission = transmissions.find(key);
+		if(transmission != transmissions.end()) {
+			retransmissionTimer.Retransmit(transmission->second);
+		}
 		NS_LOG_DEBUG(localAddress << " -> Schedule next retry");
-		timers[key] = Simulator::Schedule(Seconds(MAX_RESPONSE_WAIT_TIME + Utilities::GetJitter()), &SearchApplication::RetryRequest, this, packet, ++nTry, key);
+		double timeout = retransmissionTimer.GetTimeout(centralServerAddress, nTry);
+		timers[key] = Simulator::Schedule(Seconds(timeout + Utilities::GetJitter()), &SearchApplication::RetryRequest, this, packet, nTry + 1, key);
+	} else {
+		NS_LOG_DEBUG(localAddress << " -> Giving up request after " << MAX_TRIES << " retries");
+		transmissions.erase(key);
+		timers.erase(key);
+	}
+}
+
+void SearchApplication::AcknowledgeRequest(std::pair<uint, double> key) {
+	NS_LOG_FUNCTION(this << &key);
+	std::map<std::pair<uint, double>, TRANSMISSION>::iterator transmission = transmissions.find(key);
+	if(transmission != transmissions.end()) {
+		retransmissionTimer.Acknowledge(centralServerAddress, transmission->second);
+		transmissions.erase(transmission);
+	}
+}
+
+void SearchApplication::CancelRequest(std::pair<uint, double> key) {
+	NS_LOG_FUNCTION(this << &key);
+	std::map<std::pair<uint, double>, EventId>::iterator timer = timers.find(key);
+	if(timer != timers.end()) {
+		Simulator::Cancel(timer->second);
+		timers.erase(timer);
 	}
 }
 
@@ -193,7 +261,8 @@ void SearchApplication::ReceiveResponse(Ptr<Packet> packet) {
 	SearchScheduleHeader scheduleHeader;
 	packet->RemoveHeader(scheduleHeader);
 	NS_LOG_DEBUG(localAddress << " -> Received response: " << scheduleHeader);
-	Simulator::Cancel(timers[GetRequestKey(scheduleHeader)]);
+	AcknowledgeRequest(GetRequestKey(scheduleHeader));
+	CancelRequest(GetRequestKey(scheduleHeader));
 	if(!response) {
 		response = true;
 		NS_LOG_DEBUG(localAddress << " -> Starting service for request");
@@ -210,9 +279,21 @@ std::pair<uint, double> SearchApplication::GetRequestKey(SearchScheduleHeader re
 	return std::make_pair(address, timestamp);
 }
 
+/*
+ * Periodic notifications resend the first one every period, as they always did. Delta notifications
+ * rebuild it every period to find out what changed.
+ */
 void SearchApplication::CreateAndSendNotification() {
 	NS_LOG_FUNCTION(this);
-	SendNotification(CreateNotification());
+	SearchNotificationHeader notification = CreateNotification();
+	if(!DELTA_NOTIFICATIONS) {
+		SendNotification(notification);
+		return;
+	}
+	TypeHeader typeHeader(STRATOS_SEARCH_NOTIFICATION);
+	periodicNotificationBytes += notification.GetSerializedSize() + typeHeader.GetSerializedSize() + UDP_IP_HEADERS_SIZE;
+	CreateAndSendNotificationDelta(notification);
+	Simulator::Schedule(Seconds(HELLO_TIME + Utilities::Random(0, HELLO_TIME, STRATOS_JITTER_STREAM)), &SearchApplication::CreateAndSendNotification, this);
 }
 
 SearchNotificationHeader SearchApplication::CreateNotification() {
@@ -221,6 +302,10 @@ SearchNotificationHeader SearchApplication::CreateNotification() {
 	notification.SetNodeAddress(localAddress);
 	notification.SetCurrentPosition(positionManager->GetCurrentPosition());
 	notification.SetOfferedServices(ontologyManager->GetOfferedServices());
+	if(VELOCITY_NOTIFICATIONS) {
+		notification.SetVelocity(positionManager->GetCurrentVelocity());
+		notification.SetNotificationTimestamp(Utilities::GetCurrentRawDateTime());
+	}
 	//NS_LOG_DEBUG(localAddress << " -> Notification created: " << notification);
 	return notification;
 }
@@ -233,8 +318,54 @@ void SearchApplication::SendNotification(SearchNotificationHeader notificationHe
 	packet->AddHeader(typeHeader);
 	//NS_LOG_DEBUG(localAddress << " -> Schedule notification to send");
 	Simulator::Schedule(Seconds(Utilities::GetJitter()), &SearchApplication::SendUnicastMessage, this, packet, centralServerAddress);
+	notificationBytes += packet->GetSize() + UDP_IP_HEADERS_SIZE;
+	periodicNotificationBytes += packet->GetSize() + UDP_IP_HEADERS_SIZE;
 	//NS_LOG_DEBUG(localAddress << " -> Schedule next notification");
-	Simulator::Schedule(Seconds(HELLO_TIME + Utilities::Random(0, HELLO_TIME)), &SearchApplication::SendNotification, this, notificationHeader);
+	Simulator::Schedule(Seconds(HELLO_TIME + Utilities::Random(0, HELLO_TIME, STRATOS_JITTER_STREAM)), &SearchApplication::SendNotification, this, notificationHeader);
+}
+
+/*
+ * The keepalive carries every field, so the central recovers from a lost delta or learns about
+ * a node whose first notification was lost within one keepalive interval.
+ */
+void SearchApplication::CreateAndSendNotificationDelta(SearchNotificationHeader notification) {
+	NS_LOG_FUNCTION(this);
+	bool keepalive = !notified || Simulator::Now().GetSeconds() - lastNotificationTime >= KEEPALIVE_INTERVAL;
+	bool moved = PositionApplication::CalculateDistanceFromTo(lastNotifiedPosition, notification.GetCurrentPosition()) > NOTIFICATION_DISTANCE_THRESHOLD;
+	bool changed = lastNotifiedServices != notification.GetOfferedServices();
+	if(!keepalive && !moved && !changed) {
+		return;
+	}
+	SearchNotificationDeltaHeader deltaHeader;
+	deltaHeader.SetNodeAddress(localAddress);
+	if(keepalive || moved) {
+		deltaHeader.SetCurrentPosition(notification.GetCurrentPosition());
+		lastNotifiedPosition = notification.GetCurrentPosition();
+		if(notification.HasVelocity()) {
+			deltaHeader.SetVelocity(notification.GetVelocity());
+			deltaHeader.SetNotificationTimestamp(notification.GetNotificationTimestamp());
+		}
+	}
+	if(keepalive || changed) {
+		deltaHeader.SetOfferedServices(notification.GetOfferedServices());
+		lastNotifiedServices = notification.GetOfferedServices();
+	}
+	if(keepalive) {
+		notified = true;
+		lastNotificationTime = Simulator::Now().GetSeconds();
+	}
+	SendNotificationDelta(deltaHeader);
+}
+
+void SearchApplication::SendNotificationDelta(SearchNotificationDeltaHeader deltaHeader) {
+	NS_LOG_FUNCTION(this << deltaHeader);
+	Ptr<Packet> packet = Create<Packet>();
+	packet->AddHeader(deltaHeader);
+	TypeHeader typeHeader(STRATOS_SEARCH_NOTIFICATION_DELTA);
+	packet->AddHeader(typeHeader);
+	NS_LOG_DEBUG(localAddress << " -> Schedule notification delta to send");
+	Simulator::Schedule(Seconds(Utilities::GetJitter()), &SearchApplication::SendUnicastMessage, this, packet, centralServerAddress);
+	notificationBytes += packet->GetSize() + UDP_IP_HEADERS_SIZE;
 }
 
 SearchHelper::SearchHelper() {
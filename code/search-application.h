@@ -9,6 +9,7 @@
 #include "service-application.h"
 #include "search-error-header.h"
 #include "results-application.h"
+#include "retransmission-timer.h"
 #include "position-application.h"
 #include "ontology-application.h"
 #include "schedule-application.h"
@@ -16,6 +17,7 @@
 #include "search-response-header.h"
 #include "search-schedule-header.h"
 #include "search-notification-header.h"
+#include "search-notification-delta-header.h"
 
 using namespace ns3;
 
@@ -39,11 +41,27 @@ class SearchApplication : public Application {
 		static SearchResponseHeader SelectBestResponse(std::list<SearchResponseHeader> responses);
 
 		void CreateAndSendRequest();
+		double GetNotificationBytesSaved();
 
 	private:
 		std::map<std::pair<uint, double>, EventId> timers;
+		std::map<std::pair<uint, double>, TRANSMISSION> transmissions;
+		RetransmissionTimer retransmissionTimer;
 
 		bool response;
+		bool ADAPTIVE_TIMERS;
+		bool DELTA_NOTIFICATIONS;
+		bool VELOCITY_NOTIFICATIONS;
+		double NOTIFICATION_DISTANCE_THRESHOLD;
+		double KEEPALIVE_INTERVAL;
+
+		bool notified;
+		double lastNotificationTime;
+		POSITION lastNotifiedPosition;
+		std::list<std::string> lastNotifiedServices;
+		double notificationBytes;
+		double periodicNotificationBytes;
+
 		Ptr<Socket> socket;
 		Ipv4Address localAddress;
 		uint centralServerAddress;
@@ -60,6 +78,8 @@ class SearchApplication : public Application {
 		void SendRequest(SearchRequestHeader requestHeader);
 		std::pair<uint, double> GetRequestKey(SearchRequestHeader request);
 		void RetryRequest(Ptr<Packet> packet, int nTry, std::pair<uint, double> key);
+		void AcknowledgeRequest(std::pair<uint, double> key);
+		void CancelRequest(std::pair<uint, double> key);
 
 		void ReceiveError(Ptr<Packet> packet);
 		std::pair<uint, double> GetRequestKey(SearchErrorHeader error);
@@ -70,6 +90,8 @@ class SearchApplication : public Application {
 		void CreateAndSendNotification();
 		SearchNotificationHeader CreateNotification();
 		void SendNotification(SearchNotificationHeader notificationHeader);
+		void CreateAndSendNotificationDelta(SearchNotificationHeader notification);
+		void SendNotificationDelta(SearchNotificationDeltaHeader deltaHeader);
 };
 
 class SearchHelper : public ApplicationHelper {
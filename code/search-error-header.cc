@@ -3,6 +3,7 @@
 #include "ns3/address-utils.h"
 
 #include "utilities.h"
+#include "wire-format.h"
 
 TypeId SearchErrorHeader::GetTypeId() {
 	static TypeId typeId = TypeId("SearchErrorHeader")
@@ -16,7 +17,7 @@ TypeId SearchErrorHeader::GetInstanceTypeId() const {
 }
 
 uint32_t SearchErrorHeader::GetSerializedSize() const {
-	return 8;
+	return 12;
 }
 
 void SearchErrorHeader::Print(std::ostream &stream) const {
@@ -26,14 +27,14 @@ void SearchErrorHeader::Print(std::ostream &stream) const {
 uint32_t SearchErrorHeader::Deserialize(Buffer::Iterator start) {
 	Buffer::Iterator i = start;
 	ReadFrom(i, requestAddress);
-	requestTimestamp = i.ReadU32();
+	requestTimestamp = WireFormat::ReadTimestamp(i);
 	uint32_t size = i.GetDistanceFrom(start);
 	return size;
 }
 
 void SearchErrorHeader::Serialize(Buffer::Iterator serializer) const {
 	WriteTo(serializer, requestAddress);
-	serializer.WriteU32(requestTimestamp);
+	WireFormat::WriteTimestamp(serializer, requestTimestamp);
 }
 
 SearchErrorHeader::SearchErrorHeader() {
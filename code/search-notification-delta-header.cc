@@ -0,0 +1,198 @@
+#include "search-notification-delta-header.h"
+
+#include "ns3/address-utils.h"
+
+#include "wire-format.h"
+
+TypeId SearchNotificationDeltaHeader::GetTypeId() {
+	static TypeId typeId = TypeId("SearchNotificationDeltaHeader")
+		.SetParent<Header>()
+		.AddConstructor<SearchNotificationDeltaHeader>();
+	return typeId;
+}
+
+TypeId SearchNotificationDeltaHeader::GetInstanceTypeId() const {
+	return GetTypeId();
+}
+
+uint32_t SearchNotificationDeltaHeader::GetSerializedSize() const {
+	uint32_t size = 5;
+	if(fields & STRATOS_NOTIFICATION_POSITION) {
+		size += 8;
+	}
+	if(fields & STRATOS_NOTIFICATION_SERVICES) {
+		size += offeredServices.GetSerializedSize();
+	}
+	if(fields & STRATOS_NOTIFICATION_VELOCITY) {
+		size += 16;
+	}
+	return size;
+}
+
+void SearchNotificationDeltaHeader::Print(std::ostream &stream) const {
+	stream << "Search notification delta sent from " << nodeAddress;
+	if(fields & STRATOS_NOTIFICATION_POSITION) {
+		stream << " in (" << currentPosition.x << ", " << currentPosition.y << ")";
+	}
+	if(fields & STRATOS_NOTIFICATION_SERVICES) {
+		stream << " offering: ";
+		offeredServices.Print(stream);
+	}
+	if(fields & STRATOS_NOTIFICATION_VELOCITY) {
+		stream << " moving at (" << velocity.x << ", " << velocity.y << ") m/s since " << notificationTimestamp;
+	}
+}
+
+/*
+ * Size of the delta at start, or 0 when the bytes left can not hold the fields it flags.
+ */
+uint32_t SearchNotificationDeltaHeader::PeekSerializedSize(Buffer::Iterator start) {
+	if(start.GetRemainingSize() < 5) {
+		return 0;
+	}
+	start.Next(4);
+	uint8_t fields = start.ReadU8();
+	uint32_t size = 5;
+	if(fields & STRATOS_NOTIFICATION_POSITION) {
+		size += 8;
+		if(start.GetRemainingSize() < 8) {
+			return 0;
+		}
+		start.Next(8);
+	}
+	if(fields & STRATOS_NOTIFICATION_SERVICES) {
+		uint32_t servicesSize = ServiceList::PeekSerializedSize(start);
+		if(servicesSize == 0) {
+			return 0;
+		}
+		size += servicesSize;
+		start.Next(servicesSize);
+	}
+	if(fields & STRATOS_NOTIFICATION_VELOCITY) {
+		size += 16;
+		if(start.GetRemainingSize() < 16) {
+			return 0;
+		}
+	}
+	return size;
+}
+
+/*
+ * Deltas may come off a real socket, so a truncated one is flagged invalid and nothing is read.
+ */
+uint32_t SearchNotificationDeltaHeader::Deserialize(Buffer::Iterator start) {
+	isValid = PeekSerializedSize(start) > 0;
+	if(!isValid) {
+		return 0;
+	}
+	Buffer::Iterator i = start;
+	ReadFrom(i, nodeAddress);
+	fields = i.ReadU8();
+	if(fields & STRATOS_NOTIFICATION_POSITION) {
+		currentPosition = WireFormat::ReadPosition(i);
+	}
+	offeredServices.Clear();
+	if(fields & STRATOS_NOTIFICATION_SERVICES) {
+		offeredServices.Deserialize(i);
+	}
+	if(fields & STRATOS_NOTIFICATION_VELOCITY) {
+		velocity = WireFormat::ReadVelocity(i);
+		notificationTimestamp = WireFormat::ReadTimestamp(i);
+	}
+	uint32_t size = i.GetDistanceFrom(start);
+	return size;
+}
+
+void SearchNotificationDeltaHeader::Serialize(Buffer::Iterator serializer) const {
+	WriteTo(serializer, nodeAddress);
+	serializer.WriteU8(fields);
+	if(fields & STRATOS_NOTIFICATION_POSITION) {
+		WireFormat::WritePosition(serializer, currentPosition);
+	}
+	if(fields & STRATOS_NOTIFICATION_SERVICES) {
+		offeredServices.Serialize(serializer);
+	}
+	if(fields & STRATOS_NOTIFICATION_VELOCITY) {
+		WireFormat::WriteVelocity(serializer, velocity);
+		WireFormat::WriteTimestamp(serializer, notificationTimestamp);
+	}
+}
+
+SearchNotificationDeltaHeader::SearchNotificationDeltaHeader() {
+	isValid = true;
+	fields = 0;
+	currentPosition.x = 0;
+	currentPosition.y = 0;
+	velocity.x = 0;
+	velocity.y = 0;
+	notificationTimestamp = 0;
+	nodeAddress = Ipv4Address::GetAny();
+}
+
+bool SearchNotificationDeltaHeader::IsValid() const {
+	return isValid;
+}
+
+bool SearchNotificationDeltaHeader::HasPosition() {
+	return fields & STRATOS_NOTIFICATION_POSITION;
+}
+
+bool SearchNotificationDeltaHeader::HasOfferedServices() {
+	return fields & STRATOS_NOTIFICATION_SERVICES;
+}
+
+bool SearchNotificationDeltaHeader::HasVelocity() {
+	return fields & STRATOS_NOTIFICATION_VELOCITY;
+}
+
+Ipv4Address SearchNotificationDeltaHeader::GetNodeAddress() {
+	return nodeAddress;
+}
+
+POSITION SearchNotificationDeltaHeader::GetCurrentPosition() {
+	return currentPosition;
+}
+
+std::list<std::string> SearchNotificationDeltaHeader::GetOfferedServices() {
+	return offeredServices.GetServices();
+}
+
+const ServiceList & SearchNotificationDeltaHeader::GetOfferedServiceList() {
+	return offeredServices;
+}
+
+VELOCITY SearchNotificationDeltaHeader::GetVelocity() {
+	return velocity;
+}
+
+double SearchNotificationDeltaHeader::GetNotificationTimestamp() {
+	return notificationTimestamp;
+}
+
+void SearchNotificationDeltaHeader::SetNodeAddress(Ipv4Address nodeAddress) {
+	this->nodeAddress = nodeAddress;
+}
+
+void SearchNotificationDeltaHeader::SetCurrentPosition(POSITION currentPosition) {
+	this->currentPosition = currentPosition;
+	fields |= STRATOS_NOTIFICATION_POSITION;
+}
+
+void SearchNotificationDeltaHeader::SetOfferedServices(std::list<std::string> offeredServices) {
+	this->offeredServices.SetServices(offeredServices);
+	fields |= STRATOS_NOTIFICATION_SERVICES;
+}
+
+void SearchNotificationDeltaHeader::SetVelocity(VELOCITY velocity) {
+	this->velocity = velocity;
+	fields |= STRATOS_NOTIFICATION_VELOCITY;
+}
+
+void SearchNotificationDeltaHeader::SetNotificationTimestamp(double notificationTimestamp) {
+	this->notificationTimestamp = notificationTimestamp;
+}
+
+std::ostream & operator<< (std::ostream & stream, SearchNotificationDeltaHeader const & deltaHeader) {
+	deltaHeader.Print(stream);
+	return stream;
+}
\ No newline at end of file
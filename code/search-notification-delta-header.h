@@ -0,0 +1,58 @@
+#ifndef SEARCH_NOTIFICATION_DELTA_HEADER_H
+#define SEARCH_NOTIFICATION_DELTA_HEADER_H
+
+#include "ns3/header.h"
+#include "ns3/internet-module.h"
+
+#include "definitions.h"
+#include "service-list.h"
+
+using namespace ns3;
+
+/*
+ * Notification carrying only the fields of a node that changed since its last one,
+ * flagged with NotificationField bits. A keepalive carries all of them.
+ */
+class SearchNotificationDeltaHeader : public Header {
+
+	public:
+		static TypeId GetTypeId();
+		virtual TypeId GetInstanceTypeId() const;
+		virtual uint32_t GetSerializedSize() const;
+		virtual void Print(std::ostream &stream) const;
+		virtual uint32_t Deserialize(Buffer::Iterator start);
+		virtual void Serialize(Buffer::Iterator serializer) const;
+		static uint32_t PeekSerializedSize(Buffer::Iterator start);
+
+	private:
+		bool isValid;
+		uint8_t fields;
+		Ipv4Address nodeAddress;
+		POSITION currentPosition;
+		VELOCITY velocity;
+		double notificationTimestamp;
+		ServiceList offeredServices;
+
+	public:
+		SearchNotificationDeltaHeader();
+
+		bool IsValid() const;
+		bool HasPosition();
+		bool HasOfferedServices();
+		bool HasVelocity();
+		Ipv4Address GetNodeAddress();
+		POSITION GetCurrentPosition();
+		std::list<std::string> GetOfferedServices();
+		const ServiceList & GetOfferedServiceList();
+		VELOCITY GetVelocity();
+		double GetNotificationTimestamp();
+
+		void SetNodeAddress(Ipv4Address nodeAddress);
+		void SetCurrentPosition(POSITION currentPosition);
+		void SetOfferedServices(std::list<std::string> offeredServices);
+		void SetVelocity(VELOCITY velocity);
+		void SetNotificationTimestamp(double notificationTimestamp);
+};
+std::ostream & operator<< (std::ostream & stream, SearchNotificationDeltaHeader const & deltaHeader);
+
+#endif
\ No newline at end of file
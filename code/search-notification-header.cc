@@ -3,6 +3,7 @@
 #include "ns3/address-utils.h"
 
 #include "utilities.h"
+#include "wire-format.h"
 
 TypeId SearchNotificationHeader::GetTypeId() {
 	static TypeId typeId = TypeId("SearchNotificationHeader")
@@ -16,38 +17,53 @@ TypeId SearchNotificationHeader::GetInstanceTypeId() const {
 }
 
 uint32_t SearchNotificationHeader::GetSerializedSize() const {
-	int sum = 0;
-	for(int i = 0; i < nOfferedServices; i++) {
-		sum += offeredServicesSize[i];
-	}
-	return 14 + (nOfferedServices * 2) + sum;
+	return 13 + offeredServices.GetSerializedSize() + (hasVelocity ? 16 : 0);
 }
 
 void SearchNotificationHeader::Print(std::ostream &stream) const {
 	stream << "Search notification sent from " << nodeAddress << " in (" << currentPosition.x << ", " << currentPosition.y << ") offering: ";
-	for(std::list<std::string>::const_iterator i = offeredServices.begin(); i != offeredServices.end(); i++) {
-		stream << *i << ", ";
+	offeredServices.Print(stream);
+	if(hasVelocity) {
+		stream << "moving at (" << velocity.x << ", " << velocity.y << ") m/s since " << notificationTimestamp;
+	}
+}
+
+/*
+ * Size of the notification at start, or 0 when the bytes left can not hold it.
+ */
+uint32_t SearchNotificationHeader::PeekSerializedSize(Buffer::Iterator start) {
+	if(start.GetRemainingSize() < 12) {
+		return 0;
+	}
+	start.Next(12);
+	uint32_t servicesSize = ServiceList::PeekSerializedSize(start);
+	if(servicesSize == 0) {
+		return 0;
+	}
+	start.Next(servicesSize);
+	if(start.GetRemainingSize() < 1) {
+		return 0;
 	}
+	uint32_t velocitySize = start.ReadU8() ? 16 : 0;
+	return start.GetRemainingSize() < velocitySize ? 0 : 13 + servicesSize + velocitySize;
 }
 
+/*
+ * Notifications may come off a real socket, so a truncated one is flagged invalid and nothing is read.
+ */
 uint32_t SearchNotificationHeader::Deserialize(Buffer::Iterator start) {
+	isValid = PeekSerializedSize(start) > 0;
+	if(!isValid) {
+		return 0;
+	}
 	Buffer::Iterator i = start;
 	ReadFrom(i, nodeAddress);
-	currentPosition.x = i.ReadU32();
-	currentPosition.y = i.ReadU32();
-	nOfferedServices = i.ReadU16();
-	offeredServicesSize = new int[nOfferedServices];
-	for(int j = 0; j < nOfferedServices; j++) {
-		offeredServicesSize[j] = i.ReadU16();
-	}
-	offeredServices.clear();
-	for(int j = 0; j < nOfferedServices; j++) {
-		char tmp[offeredServicesSize[j] + 1];
-		for(int k = 0; k < offeredServicesSize[j]; k++) {
-			tmp[k] = i.ReadU8();
-		}
-		tmp[offeredServicesSize[j]] = '\0';
-		offeredServices.push_back(std::string(tmp));
+	currentPosition = WireFormat::ReadPosition(i);
+	offeredServices.Deserialize(i);
+	hasVelocity = i.ReadU8();
+	if(hasVelocity) {
+		velocity = WireFormat::ReadVelocity(i);
+		notificationTimestamp = WireFormat::ReadTimestamp(i);
 	}
 	uint32_t size = i.GetDistanceFrom(start);
 	return size;
@@ -55,28 +71,30 @@ uint32_t SearchNotificationHeader::Deserialize(Buffer::Iterator start) {
 
 void SearchNotificationHeader::Serialize(Buffer::Iterator serializer) const {
 	WriteTo(serializer, nodeAddress);
-	serializer.WriteU32(currentPosition.x);
-	serializer.WriteU32(currentPosition.y);
-	serializer.WriteU16(nOfferedServices);
-	for(int j = 0; j < nOfferedServices; j++) {
-		serializer.WriteU16(offeredServicesSize[j]);
-	}
-	for(std::list<std::string>::const_iterator j = offeredServices.begin(); j != offeredServices.end(); j++) {
-		std::string service = *j;
-		for(int k = 0; k < (int) service.length(); k++) {
-			serializer.WriteU8(service.at(k));
-		}
+	WireFormat::WritePosition(serializer, currentPosition);
+	offeredServices.Serialize(serializer);
+	serializer.WriteU8(hasVelocity);
+	if(hasVelocity) {
+		WireFormat::WriteVelocity(serializer, velocity);
+		WireFormat::WriteTimestamp(serializer, notificationTimestamp);
 	}
 }
 
 SearchNotificationHeader::SearchNotificationHeader() {
-	nOfferedServices = 0;
+	isValid = true;
 	currentPosition.x = 0;
 	currentPosition.y = 0;
-	offeredServicesSize = NULL;
+	hasVelocity = false;
+	velocity.x = 0;
+	velocity.y = 0;
+	notificationTimestamp = 0;
 	nodeAddress = Ipv4Address::GetAny();
 }
 
+bool SearchNotificationHeader::IsValid() const {
+	return isValid;
+}
+
 Ipv4Address SearchNotificationHeader::GetNodeAddress() {
 	return nodeAddress;
 }
@@ -86,9 +104,25 @@ POSITION SearchNotificationHeader::GetCurrentPosition() {
 }
 
 std::list<std::string> SearchNotificationHeader::GetOfferedServices() {
+	return offeredServices.GetServices();
+}
+
+const ServiceList & SearchNotificationHeader::GetOfferedServiceList() {
 	return offeredServices;
 }
 
+bool SearchNotificationHeader::HasVelocity() {
+	return hasVelocity;
+}
+
+VELOCITY SearchNotificationHeader::GetVelocity() {
+	return velocity;
+}
+
+double SearchNotificationHeader::GetNotificationTimestamp() {
+	return notificationTimestamp;
+}
+
 void SearchNotificationHeader::SetNodeAddress(Ipv4Address nodeAddress) {
 	this->nodeAddress = nodeAddress;
 }
@@ -98,13 +132,16 @@ void SearchNotificationHeader::SetCurrentPosition(POSITION currentPosition) {
 }
 
 void SearchNotificationHeader::SetOfferedServices(std::list<std::string> offeredServices) {
-	this->offeredServices = offeredServices;
-	nOfferedServices = offeredServices.size();
-	offeredServicesSize = new int[nOfferedServices];
-	int i = 0;
-	for(std::list<std::string>::iterator j = offeredServices.begin(); j != offeredServices.end(); j++) {
-		offeredServicesSize[i++] = (*j).length();
-	}
+	this->offeredServices.SetServices(offeredServices);
+}
+
+void SearchNotificationHeader::SetVelocity(VELOCITY velocity) {
+	this->velocity = velocity;
+	hasVelocity = true;
+}
+
+void SearchNotificationHeader::SetNotificationTimestamp(double notificationTimestamp) {
+	this->notificationTimestamp = notificationTimestamp;
 }
 
 std::ostream & operator<< (std::ostream & stream, SearchNotificationHeader const & notificationHeader) {
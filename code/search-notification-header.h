@@ -4,7 +4,10 @@
 #include "ns3/header.h"
 #include "ns3/internet-module.h"
 
+#include <vector>
+
 #include "definitions.h"
+#include "service-list.h"
 
 using namespace ns3;
 
@@ -17,25 +20,35 @@ class SearchNotificationHeader : public Header {
 		virtual void Print(std::ostream &stream) const;
 		virtual uint32_t Deserialize(Buffer::Iterator start);
 		virtual void Serialize(Buffer::Iterator serializer) const;
+		static uint32_t PeekSerializedSize(Buffer::Iterator start);
 
 	private:
-		int nOfferedServices;
-		int *offeredServicesSize;
+		bool isValid;
+		bool hasVelocity;
+		VELOCITY velocity;
+		double notificationTimestamp;
 
 		Ipv4Address nodeAddress;
 		POSITION currentPosition;
-		std::list<std::string> offeredServices;
+		ServiceList offeredServices;
 
 	public:
 		SearchNotificationHeader();
 
+		bool IsValid() const;
 		Ipv4Address GetNodeAddress();
 		POSITION GetCurrentPosition();
 		std::list<std::string> GetOfferedServices();
+		const ServiceList & GetOfferedServiceList();
+		bool HasVelocity();
+		VELOCITY GetVelocity();
+		double GetNotificationTimestamp();
 
 		void SetNodeAddress(Ipv4Address nodeAddress);
 		void SetCurrentPosition(POSITION currentPosition);
 		void SetOfferedServices(std::list<std::string> offeredServices);
+		void SetVelocity(VELOCITY velocity);
+		void SetNotificationTimestamp(double notificationTimestamp);
 };
 std::ostream & operator<< (std::ostream & stream, SearchNotificationHeader const & notificationHeader);
 
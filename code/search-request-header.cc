@@ -3,6 +3,8 @@
 #include "ns3/address-utils.h"
 
 #include "utilities.h"
+#include "service-codec.h"
+#include "wire-format.h"
 
 TypeId SearchRequestHeader::GetTypeId() {
 	static TypeId typeId = TypeId("SearchRequestHeader")
@@ -16,53 +18,66 @@ TypeId SearchRequestHeader::GetInstanceTypeId() const {
 }
 
 uint32_t SearchRequestHeader::GetSerializedSize() const {
-	return 22 + requestedServiceSize;
+	return 24 + ServiceCodec::GetSerializedSize(requestedServiceId, requestedService);
 }
 
 void SearchRequestHeader::Print(std::ostream &stream) const {
-	stream << "Search request sent from " << requestAddress << " at " << requestTimestamp << " in (" << requestPosition.x << ", " << requestPosition.y << "), looking for " << requestedService << " within " << maxDistanceAllowed << "m.";
+	stream << "Search request sent from " << requestAddress << " at " << requestTimestamp << " in (" << requestPosition.x << ", " << requestPosition.y << "), looking for " << ServiceCodec::GetService(requestedServiceId, requestedService) << " within " << maxDistanceAllowed << "m.";
 }
 
+/*
+ * Size of the request at start, or 0 when the bytes left can not hold it.
+ */
+uint32_t SearchRequestHeader::PeekSerializedSize(Buffer::Iterator start) {
+	if(start.GetRemainingSize() < 24) {
+		return 0;
+	}
+	start.Next(24);
+	uint32_t serviceSize = ServiceCodec::PeekSerializedSize(start);
+	return serviceSize == 0 ? 0 : 24 + serviceSize;
+}
+
+/*
+ * Requests may come off a real socket, so a truncated one is flagged invalid and nothing is read.
+ */
 uint32_t SearchRequestHeader::Deserialize(Buffer::Iterator start) {
+	isValid = PeekSerializedSize(start) > 0;
+	if(!isValid) {
+		return 0;
+	}
 	Buffer::Iterator i = start;
 	ReadFrom(i, requestAddress);
-	requestTimestamp = i.ReadU32();
-	requestPosition.x = i.ReadU32();
-	requestPosition.y = i.ReadU32();
-	maxDistanceAllowed = i.ReadU32();
-	requestedServiceSize = i.ReadU16();
-	char tmp[requestedServiceSize + 1];
-	for(int j = 0; j < requestedServiceSize; j++) {
-		tmp[j] = i.ReadU8();
-	}
-	tmp[requestedServiceSize] = '\0';
-	requestedService = std::string(tmp);
+	requestTimestamp = WireFormat::ReadTimestamp(i);
+	requestPosition = WireFormat::ReadPosition(i);
+	maxDistanceAllowed = WireFormat::ReadDistance(i);
+	requestedServiceId = ServiceCodec::Deserialize(i, requestedService);
 	uint32_t size = i.GetDistanceFrom(start);
 	return size;
 }
 
 void SearchRequestHeader::Serialize(Buffer::Iterator serializer) const {
 	WriteTo(serializer, requestAddress);
-	serializer.WriteU32(requestTimestamp);
-	serializer.WriteU32(requestPosition.x);
-	serializer.WriteU32(requestPosition.y);
-	serializer.WriteU32(maxDistanceAllowed);
-	serializer.WriteU16(requestedServiceSize);
-	for(int i = 0; i < requestedServiceSize; i++) {
-		serializer.WriteU8(requestedService.at(i));
-	}
+	WireFormat::WriteTimestamp(serializer, requestTimestamp);
+	WireFormat::WritePosition(serializer, requestPosition);
+	WireFormat::WriteDistance(serializer, maxDistanceAllowed);
+	ServiceCodec::Serialize(serializer, requestedServiceId, requestedService);
 }
 
 SearchRequestHeader::SearchRequestHeader() {
+	isValid = true;
 	requestPosition.x = 0;
 	requestPosition.y = 0;
 	requestedService = "0";
 	maxDistanceAllowed = 0;
-	requestedServiceSize = 1;
+	requestedServiceId = UNKNOWN_SERVICE;
 	requestAddress = Ipv4Address::GetAny();
 	requestTimestamp = Utilities::GetCurrentRawDateTime();
 }
 
+bool SearchRequestHeader::IsValid() const {
+	return isValid;
+}
+
 double SearchRequestHeader::GetRequestTimestamp() {
 	return requestTimestamp;
 }
@@ -80,7 +95,11 @@ Ipv4Address SearchRequestHeader::GetRequestAddress() {
 }
 
 std::string SearchRequestHeader::GetRequestedService() {
-	return requestedService;
+	return ServiceCodec::GetService(requestedServiceId, requestedService);
+}
+
+int SearchRequestHeader::GetRequestedServiceId() {
+	return requestedServiceId;
 }
 
 void SearchRequestHeader::SetRequestTimestamp(double requestTimestamp) {
@@ -100,8 +119,8 @@ void SearchRequestHeader::SetMaxDistanceAllowed(double maxDistanceAllowed) {
 }
 
 void SearchRequestHeader::SetRequestedService(std::string requestedService) {
-	this->requestedService = requestedService;
-	requestedServiceSize = requestedService.length();
+	requestedServiceId = ServiceCodec::GetServiceId(requestedService);
+	this->requestedService = requestedServiceId == UNKNOWN_SERVICE ? requestedService : std::string();
 }
 
 std::ostream & operator<< (std::ostream & stream, SearchRequestHeader const & requestHeader) {
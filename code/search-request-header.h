@@ -17,9 +17,11 @@ class SearchRequestHeader : public Header {
 		virtual void Print(std::ostream &stream) const;
 		virtual uint32_t Deserialize(Buffer::Iterator start);
 		virtual void Serialize(Buffer::Iterator serializer) const;
+		static uint32_t PeekSerializedSize(Buffer::Iterator start);
 
 	private:
-		int requestedServiceSize;
+		bool isValid;
+		int requestedServiceId;
 
 		double requestTimestamp;
 		POSITION requestPosition;
@@ -30,11 +32,13 @@ class SearchRequestHeader : public Header {
 	public:
 		SearchRequestHeader();
 
+		bool IsValid() const;
 		double GetRequestTimestamp();
 		POSITION GetRequestPosition();
 		double GetMaxDistanceAllowed();
 		Ipv4Address GetRequestAddress();
 		std::string GetRequestedService();
+		int GetRequestedServiceId();
 
 		void SetRequestTimestamp(double requestTimestamp);
 		void SetRequestPosition(POSITION requestPosition);
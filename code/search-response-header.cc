@@ -3,6 +3,8 @@
 #include "ns3/address-utils.h"
 
 #include "utilities.h"
+#include "service-codec.h"
+#include "wire-format.h"
 
 TypeId SearchResponseHeader::GetTypeId() {
 	static TypeId typeId = TypeId("SearchResponseHeader")
@@ -16,45 +18,36 @@ TypeId SearchResponseHeader::GetInstanceTypeId() const {
 }
 
 uint32_t SearchResponseHeader::GetSerializedSize() const {
-	return 20 + offeredServiceSize;
+	return 22 + ServiceCodec::GetSerializedSize(offeredServiceId, offeredService.service);
 }
 
 void SearchResponseHeader::Print(std::ostream &stream) const {
-	stream << "Search response to " << requestAddress << " at " << requestTimestamp << ", response sent from " << responseAddress << " at " << distance << "m far, provided service is " << offeredService.service << " with " << offeredService.semanticDistance << " semantic distance";
+	stream << "Search response to " << requestAddress << " at " << requestTimestamp << ", response sent from " << responseAddress << " at " << distance << "m far, provided service is " << ServiceCodec::GetService(offeredServiceId, offeredService.service) << " with " << offeredService.semanticDistance << " semantic distance";
 }
 
 uint32_t SearchResponseHeader::Deserialize(Buffer::Iterator start) {
 	Buffer::Iterator i = start;
-	distance = i.ReadU32();
+	distance = WireFormat::ReadDistance(i);
 	ReadFrom(i, requestAddress);
 	ReadFrom(i, responseAddress);
-	requestTimestamp = i.ReadU32();
+	requestTimestamp = WireFormat::ReadTimestamp(i);
 	offeredService.semanticDistance = i.ReadU16();
-	offeredServiceSize = i.ReadU16();
-	char tmp[offeredServiceSize + 1];
-	for(int j = 0; j < offeredServiceSize; j++) {
-		tmp[j] = i.ReadU8();
-	}
-	tmp[offeredServiceSize] = '\0';
-	offeredService.service = std::string(tmp);
+	offeredServiceId = ServiceCodec::Deserialize(i, offeredService.service);
 	uint32_t size = i.GetDistanceFrom(start);
 	return size;
 }
 
 void SearchResponseHeader::Serialize(Buffer::Iterator serializer) const {
-	serializer.WriteU32(distance);
+	WireFormat::WriteDistance(serializer, distance);
 	WriteTo(serializer, requestAddress);
 	WriteTo(serializer, responseAddress);
-	serializer.WriteU32(requestTimestamp);
+	WireFormat::WriteTimestamp(serializer, requestTimestamp);
 	serializer.WriteU16(offeredService.semanticDistance);
-	serializer.WriteU16(offeredServiceSize);
-	for(int i = 0; i < offeredServiceSize; i++) {
-		serializer.WriteU8(offeredService.service.at(i));
-	}
+	ServiceCodec::Serialize(serializer, offeredServiceId, offeredService.service);
 }
 
 SearchResponseHeader::SearchResponseHeader() {
-	offeredServiceSize = 1;
+	offeredServiceId = UNKNOWN_SERVICE;
 	offeredService.service = "0";
 	requestAddress = Ipv4Address::GetAny();
 	responseAddress = Ipv4Address::GetAny();
@@ -80,7 +73,13 @@ Ipv4Address SearchResponseHeader::GetResponseAddress() {
 }
 
 OFFERED_SERVICE SearchResponseHeader::GetOfferedService() {
-	return offeredService;
+	OFFERED_SERVICE service = offeredService;
+	service.service = ServiceCodec::GetService(offeredServiceId, offeredService.service);
+	return service;
+}
+
+int SearchResponseHeader::GetOfferedServiceId() {
+	return offeredServiceId;
 }
 
 void SearchResponseHeader::SetDistance(double distance) {
@@ -101,7 +100,10 @@ void SearchResponseHeader::SetResponseAddress(Ipv4Address responseAddress) {
 
 void SearchResponseHeader::SetOfferedService(OFFERED_SERVICE offeredService) {
 	this->offeredService = offeredService;
-	offeredServiceSize = offeredService.service.length();
+	offeredServiceId = ServiceCodec::GetServiceId(offeredService.service);
+	if(offeredServiceId != UNKNOWN_SERVICE) {
+		this->offeredService.service.clear();
+	}
 }
 
 std::ostream & operator<< (std::ostream & stream, SearchResponseHeader const & responseHeader) {
@@ -19,7 +19,7 @@ class SearchResponseHeader : public Header {
 		virtual void Serialize(Buffer::Iterator serializer) const;
 
 	private:
-		int offeredServiceSize;
+		int offeredServiceId;
 
 		double distance;
 		double requestTimestamp;
@@ -31,16 +31,15 @@ class SearchResponseHeader : public Header {
 		SearchResponseHeader();
 
 		double GetDistance();
-		int GetOfferedServiceSize();
 		double GetRequestTimestamp();
 		Ipv4Address GetRequestAddress();
 		Ipv4Address GetResponseAddress();
 		OFFERED_SERVICE GetOfferedService();
+		int GetOfferedServiceId();
 
 		void SetDistance(double distance);
 		void SetRequestTimestamp(double requestTimestamp);
 		void SetRequestAddress(Ipv4Address requestAddress);
-		void SetOfferedServiceSize(int offeredServiceSize);
 		void SetResponseAddress(Ipv4Address responseAddress);
 		void SetOfferedService(OFFERED_SERVICE offeredService);
 };
@@ -3,6 +3,7 @@
 #include "ns3/address-utils.h"
 
 #include "utilities.h"
+#include "wire-format.h"
 
 TypeId SearchScheduleHeader::GetTypeId() {
 	static TypeId typeId = TypeId("SearchScheduleHeader")
@@ -16,7 +17,7 @@ TypeId SearchScheduleHeader::GetInstanceTypeId() const {
 }
 
 uint32_t SearchScheduleHeader::GetSerializedSize() const {
-	return 10 + serializedScheduleSize;
+	return 14 + serializedScheduleSize;
 }
 
 void SearchScheduleHeader::Print(std::ostream &stream) const {
@@ -31,7 +32,7 @@ void SearchScheduleHeader::Print(std::ostream &stream) const {
 uint32_t SearchScheduleHeader::Deserialize(Buffer::Iterator start) {
 	Buffer::Iterator i = start;
 	ReadFrom(i, requestAddress);
-	requestTimestamp = i.ReadU32();
+	requestTimestamp = WireFormat::ReadTimestamp(i);
 	int scheduleSize = i.ReadU16();
 	for(int j = 0; j < scheduleSize; j++) {
 		SearchResponseHeader response;
@@ -45,7 +46,7 @@ uint32_t SearchScheduleHeader::Deserialize(Buffer::Iterator start) {
 
 void SearchScheduleHeader::Serialize(Buffer::Iterator serializer) const {
 	WriteTo(serializer, requestAddress);
-	serializer.WriteU32(requestTimestamp);
+	WireFormat::WriteTimestamp(serializer, requestTimestamp);
 	serializer.WriteU16(schedule.size());
 	for(std::list<SearchResponseHeader>::const_iterator i = schedule.begin(); i != schedule.end(); i++) {
 		(*i).Serialize(serializer);
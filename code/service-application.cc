@@ -1,8 +1,11 @@
 #include "service-application.h"
 
+#include <algorithm>
+
 #include "utilities.h"
 #include "definitions.h"
 #include "type-header.h"
+#include "service-catalog.h"
 
 NS_LOG_COMPONENT_DEFINE("ServiceApplication");
 
@@ -17,7 +20,17 @@ TypeId ServiceApplication::GetTypeId() {
 						"Number of service packets to send.",
 						IntegerValue(10),
 						MakeIntegerAccessor(&ServiceApplication::NUMBER_OF_PACKETS_TO_SEND),
-						MakeIntegerChecker<int>());
+						MakeIntegerChecker<int>())
+		.AddAttribute("window",
+						"Max number of data packets in flight in a service session, 1 keeps stop-and-wait.",
+						IntegerValue(1),
+						MakeIntegerAccessor(&ServiceApplication::WINDOW_SIZE),
+						MakeIntegerChecker<int>(1))
+		.AddAttribute("adaptiveTimers",
+						"Derive retransmission timeouts from the measured RTT to each peer instead of a fixed wait.",
+						BooleanValue(false),
+						MakeBooleanAccessor(&ServiceApplication::ADAPTIVE_TIMERS),
+						MakeBooleanChecker());
 	return typeId;
 }
 
@@ -34,6 +47,7 @@ void ServiceApplication::DoInitialize() {
 	resultsManager = DynamicCast<ResultsApplication>(GetNode()->GetApplication(4));
 	ontologyManager = DynamicCast<OntologyApplication>(GetNode()->GetApplication(0));
 	localAddress = GetNode()->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal();
+	retransmissionTimer.SetAdaptive(ADAPTIVE_TIMERS);
 	socket = Socket::CreateSocket(GetNode(), UdpSocketFactory::GetTypeId());
 	socket->SetAllowBroadcast(false);
 	InetSocketAddress local = InetSocketAddress(localAddress, SERVICE_PORT);
@@ -59,15 +73,17 @@ void ServiceApplication::StopApplication() {
 	if(socket != NULL) {
 		socket->SetRecvCallback(MakeNullCallback<void, Ptr<Socket> >());
 	}
+	NS_LOG_INFO(localAddress << " -> " << retransmissionTimer.GetRetransmits() << " retransmits, " << retransmissionTimer.GetSpuriousRetransmits() << " spurious and " << (retransmissionTimer.GetRetransmits() - retransmissionTimer.GetSpuriousRetransmits()) << " genuine");
 }
 
 void ServiceApplication::CreateAndSendRequest(Ipv4Address destinationAddress, std::string service, int requestPackets) {
 	NS_LOG_FUNCTION(this << destinationAddress << service << requestPackets);
 	ServiceRequestResponseHeader request = CreateRequest(destinationAddress, service);
+	SERVICE_SESSION &session = sessions.Get(GetDestinationKey(request));
+	session.window = WINDOW_SIZE;
+	session.maxPackets = requestPackets;
+	session.status = STRATOS_START_SERVICE;
 	SendRequest(request);
-	std::pair<uint, std::string> key = GetDestinationKey(request);
-	maxPackets[key] = requestPackets;
-	status[key] = STRATOS_START_SERVICE;
 	NS_LOG_DEBUG(localAddress << " -> Service for " << destinationAddress << " requesting " << requestPackets << " packets is in state " << STRATOS_START_SERVICE);
 }
 
@@ -97,19 +113,66 @@ void ServiceApplication::ReceiveMessage(Ptr<Socket> socket) {
 	}
 }
 
-void ServiceApplication::SetCallback(Callback<void> continueScheduleCallback) {
+void ServiceApplication::SetCallback(Callback<void, Ipv4Address, int> continueScheduleCallback) {
 	this->continueScheduleCallback = continueScheduleCallback;
 }
 
-void ServiceApplication::CancelService(std::pair<uint, std::string> key) {
+bool ServiceApplication::AddPackets(Ipv4Address destinationAddress, std::string service, int extraPackets) {
+	NS_LOG_FUNCTION(this << destinationAddress << service << extraPackets);
+	SERVICE_SESSION *session = sessions.Find(std::make_pair(destinationAddress.Get(), ServiceCatalog::GetServiceId(service)));
+	if(session == NULL || (session->status != STRATOS_START_SERVICE && session->status != STRATOS_DO_SERVICE)) {
+		NS_LOG_DEBUG(localAddress << " -> Service for " << destinationAddress << " is in state " << (session == NULL ? STRATOS_NULL : session->status) << " and can not send more packets");
+		return false;
+	}
+	session->maxPackets += extraPackets;
+	NS_LOG_DEBUG(localAddress << " -> Service for " << destinationAddress << " now requests " << session->maxPackets << " packets");
+	return true;
+}
+
+void ServiceApplication::CancelService(SESSION_KEY key) {
 	NS_LOG_FUNCTION(this << &key);
-	status[key] = STRATOS_SERVICE_STOPPED;
-	NS_LOG_DEBUG(localAddress << " -> Service for " << key.first << " is in state " << STRATOS_SERVICE_STOPPED);
+	SERVICE_SESSION *session = sessions.Find(key);
+	if(session == NULL) {
+		NS_LOG_DEBUG(localAddress << " -> Service for " << key.first << " was already released");
+		return;
+	}
+	int nPackets = session->packets;
+	Simulator::Cancel(session->timer);
+	Simulator::Cancel(session->resend);
+	sessions.Erase(key);
+	NS_LOG_DEBUG(localAddress << " -> Service for " << key.first << " is in state " << STRATOS_SERVICE_STOPPED << " and released");
 	if(continueScheduleCallback.IsNull()) {
 		NS_LOG_ERROR(localAddress << " -> Schedule Callback must not be null!");
 		return;
 	}
-	continueScheduleCallback();
+	continueScheduleCallback(Ipv4Address(key.first), nPackets);
+}
+
+/*
+ * A session nothing is waiting for anymore, after answering an out of sync message with an
+ * error, would never be touched again, so it is released instead of kept until the end.
+ */
+void ServiceApplication::ReleaseIdleSession(SESSION_KEY key) {
+	NS_LOG_FUNCTION(this << &key);
+	SERVICE_SESSION *session = sessions.Find(key);
+	if(session != NULL && !session->timer.IsRunning()) {
+		NS_LOG_DEBUG(localAddress << " -> Releasing idle service for [" << key.first << ", " << key.second << "] in state " << session->status);
+		Simulator::Cancel(session->resend);
+		sessions.Erase(key);
+	}
+}
+
+void ServiceApplication::AcknowledgeTransmission(SESSION_KEY key) {
+	NS_LOG_FUNCTION(this << &key);
+	SERVICE_SESSION *session = sessions.Find(key);
+	if(session == NULL || !session->inFlight) {
+		return;
+	}
+	//Answers in a streaming session may acknowledge packets sent before the last one
+	if(session->window <= 1) {
+		retransmissionTimer.Acknowledge(key.first, session->transmission);
+	}
+	session->inFlight = false;
 }
 
 void ServiceApplication::SendUnicastMessage(Ptr<Packet> packet, uint destinationAddress) {
@@ -119,37 +182,44 @@ void ServiceApplication::SendUnicastMessage(Ptr<Packet> packet, uint destination
 	socket->Send(packet);
 }
 
-std::pair<uint, std::string> ServiceApplication::GetSenderKey(ServiceErrorHeader errorHeader) {
+SESSION_KEY ServiceApplication::GetSenderKey(ServiceErrorHeader errorHeader) {
 	NS_LOG_FUNCTION(this << errorHeader);
-	std::string service = errorHeader.GetService();
+	int serviceId = errorHeader.GetServiceId();
 	uint senderAddress = errorHeader.GetSenderAddress().Get();
-	NS_LOG_DEBUG(localAddress << " -> Sender key from error is [" << senderAddress << ", " << service << "] " << errorHeader);
-	return std::make_pair(senderAddress, service);
+	NS_LOG_DEBUG(localAddress << " -> Sender key from error is [" << senderAddress << ", " << serviceId << "] " << errorHeader);
+	return std::make_pair(senderAddress, serviceId);
 }
 
-std::pair<uint, std::string> ServiceApplication::GetSenderKey(ServiceRequestResponseHeader requestResponse) {
+SESSION_KEY ServiceApplication::GetSenderKey(ServiceRequestResponseHeader requestResponse) {
 	NS_LOG_FUNCTION(this << requestResponse);
-	std::string service = requestResponse.GetService();
+	int serviceId = requestResponse.GetServiceId();
 	uint senderAddress = requestResponse.GetSenderAddress().Get();
-	NS_LOG_DEBUG(localAddress << " -> Sender key is [" << senderAddress << ", " << service << "] " << requestResponse);
-	return std::make_pair(senderAddress, service);
+	NS_LOG_DEBUG(localAddress << " -> Sender key is [" << senderAddress << ", " << serviceId << "] " << requestResponse);
+	return std::make_pair(senderAddress, serviceId);
 }
 
-std::pair<uint, std::string> ServiceApplication::GetDestinationKey(ServiceRequestResponseHeader requestResponse) {
+SESSION_KEY ServiceApplication::GetDestinationKey(ServiceRequestResponseHeader requestResponse) {
 	NS_LOG_FUNCTION(this << requestResponse);
-	std::string service = requestResponse.GetService();
+	int serviceId = requestResponse.GetServiceId();
 	uint destinationAddress = requestResponse.GetDestinationAddress().Get();
-	NS_LOG_DEBUG(localAddress << " -> Destination key is [" << destinationAddress << ", " << service << "] " << requestResponse);
-	return std::make_pair(destinationAddress, service);
+	NS_LOG_DEBUG(localAddress << " -> Destination key is [" << destinationAddress << ", " << serviceId << "] " << requestResponse);
+	return std::make_pair(destinationAddress, serviceId);
 }
 
-void ServiceApplication::Retry(Ptr<Packet> packet, int nTry, std::pair<uint, std::string> key, uint destinationAddress)  {
+void ServiceApplication::Retry(Ptr<Packet> packet, int nTry, SESSION_KEY key, uint destinationAddress)  {
 	NS_LOG_FUNCTION(this << packet << nTry << &key << destinationAddress);
-	if (nTry <= MAX_TRIES) {
+	SERVICE_SESSION *session = sessions.Find(key);
+	if (nTry <= MAX_TRIES && session != NULL) {
 		NS_LOG_DEBUG(localAddress << " -> Retrying request (" << nTry << ")");
 		Simulator::Schedule(Seconds(Utilities::GetJitter()), &ServiceApplication::SendUnicastMessage, this, packet, destinationAddress);
+		if(!session->inFlight) {
+			session->transmission = retransmissionTimer.Send();
+			session->inFlight = true;
+		}
+		retransmissionTimer.Retransmit(session->transmission);
 		NS_LOG_DEBUG(localAddress << " -> Schedule next retry");
-		resends[key] = Simulator::Schedule(Seconds(MAX_RESPONSE_WAIT_TIME + Utilities::GetJitter()), &ServiceApplication::Retry, this, packet, ++nTry, key, destinationAddress);
+		double timeout = retransmissionTimer.GetTimeout(destinationAddress, nTry);
+		session->resend = Simulator::Schedule(Seconds(timeout + Utilities::GetJitter()), &ServiceApplication::Retry, this, packet, nTry + 1, key, destinationAddress);
 	}
 }
 
@@ -164,66 +234,114 @@ void ServiceApplication::ReceiveRequest(Ptr<Packet> packet) {
 		return;
 	}
 	Flag flag;
-	std::pair<uint, std::string> requester = GetSenderKey(requestHeader);
-	Simulator::Cancel(timers[requester]);
-	Simulator::Cancel(resends[requester]);
-	Flag currentStatus = status[requester];
+	SESSION_KEY requester = GetSenderKey(requestHeader);
+	AcknowledgeTransmission(requester);
+	SERVICE_SESSION *session = sessions.Find(requester);
+	Flag currentStatus = STRATOS_NULL;
+	if(session != NULL) {
+		Simulator::Cancel(session->timer);
+		if(requestHeader.GetFlag() != STRATOS_DO_SERVICE || session->window <= 1) {
+			Simulator::Cancel(session->resend);
+		}
+		currentStatus = session->status;
+	}
 	NS_LOG_DEBUG(localAddress << " -> Service for [" << requester.first << ", " << requester.second << "] is in state " << currentStatus);
 	NS_LOG_DEBUG(localAddress << " -> Request [" << requester.first << ", " << requester.second << "] has flag " << requestHeader.GetFlag());
 	switch(requestHeader.GetFlag()) {
 		case STRATOS_START_SERVICE:
 			if(currentStatus == STRATOS_NULL) {
 				flag = STRATOS_SERVICE_STARTED;
-				status[requester] = STRATOS_DO_SERVICE;
+				session = &sessions.Get(requester);
+				session->status = STRATOS_DO_SERVICE;
+				session->window = requestHeader.GetWindow();
 				NS_LOG_DEBUG(localAddress << " -> Service for [" << requester.first << ", " << requester.second << "] changes to state " << STRATOS_DO_SERVICE);
 				CreateAndSendResponse(requestHeader, flag);
 			} else {
-				NS_LOG_DEBUG(localAddress << " -> Request [" << requester.first << ", " << requester.second << "] out of sync, sending error");
+				NS_LOG_DEBUG(localAddress << " -> Request [" << requester.first << ", " << requester.second << "] out of sync, sending error");
 				CreateAndSendError(requestHeader);
 			}
 		break;
 		case STRATOS_DO_SERVICE:
-			if(currentStatus == STRATOS_DO_SERVICE) {
-				if(packets[requester] < NUMBER_OF_PACKETS_TO_SEND) {
+			if(currentStatus == STRATOS_DO_SERVICE && session->window > 1) {
+				ReceiveAcknowledgement(requestHeader);
+			} else if(currentStatus == STRATOS_DO_SERVICE) {
+				if(session->packets < NUMBER_OF_PACKETS_TO_SEND) {
 					flag = STRATOS_DO_SERVICE;
-					packets[requester] += 1;
+					session->packets += 1;
 					NS_LOG_DEBUG(localAddress << " -> Sending data packet to request [" << requester.first << ", " << requester.second << "]");
 				} else {
 					flag = STRATOS_SERVICE_STOPPED;
-					status[requester] = STRATOS_SERVICE_STOPPED;
+					session->status = STRATOS_SERVICE_STOPPED;
 					NS_LOG_DEBUG(localAddress << " -> No data left for request [" << requester.first << ", " << requester.second << "]");
 					NS_LOG_DEBUG(localAddress << " -> Service for [" << requester.first << ", " << requester.second << "] changes to state " << STRATOS_SERVICE_STOPPED);
 				}
 				CreateAndSendResponse(requestHeader, flag);
 			} else {
-				NS_LOG_DEBUG(localAddress << " -> Request [" << requester.first << ", " << requester.second << "] out of sync, sending error");
+				NS_LOG_DEBUG(localAddress << " -> Request [" << requester.first << ", " << requester.second << "] out of sync, sending error");
 				CreateAndSendError(requestHeader);
 			}
 		break;
 		case STRATOS_STOP_SERVICE:
 			flag = STRATOS_SERVICE_STOPPED;
-			status[requester] = STRATOS_SERVICE_STOPPED;
+			//Kept until its timer expires, so retransmitted requests of the session are answered
+			sessions.Get(requester).status = STRATOS_SERVICE_STOPPED;
 			NS_LOG_DEBUG(localAddress << " -> Service for [" << requester.first << ", " << requester.second << "] changes to state " << STRATOS_SERVICE_STOPPED);
 			CreateAndSendResponse(requestHeader, flag);
 		break;
 		default:
 			NS_LOG_WARN(localAddress << " -> Request [" << requester.first << ", " << requester.second << "] has unknown flag " << requestHeader.GetFlag());
 	}
+	ReleaseIdleSession(requester);
+}
+
+void ServiceApplication::ReceiveAcknowledgement(ServiceRequestResponseHeader requestHeader) {
+	NS_LOG_FUNCTION(this << requestHeader);
+	SESSION_KEY requester = GetSenderKey(requestHeader);
+	SERVICE_SESSION &session = sessions.Get(requester);
+	int acknowledgement = requestHeader.GetAcknowledgement();
+	if(acknowledgement >= NUMBER_OF_PACKETS_TO_SEND) {
+		Simulator::Cancel(session.resend);
+		session.status = STRATOS_SERVICE_STOPPED;
+		NS_LOG_DEBUG(localAddress << " -> No data left for request [" << requester.first << ", " << requester.second << "]");
+		NS_LOG_DEBUG(localAddress << " -> Service for [" << requester.first << ", " << requester.second << "] changes to state " << STRATOS_SERVICE_STOPPED);
+		CreateAndSendResponse(requestHeader, STRATOS_SERVICE_STOPPED);
+		return;
+	}
+	//The pending retry is either for the acknowledged packet or, with nothing in flight, for the start of the service
+	if(acknowledgement > session.acknowledgements || session.packets == session.acknowledgements) {
+		session.acknowledgements = std::max(acknowledgement, session.acknowledgements);
+		Simulator::Cancel(session.resend);
+	}
+	NS_LOG_DEBUG(localAddress << " -> Request [" << requester.first << ", " << requester.second << "] acknowledges " << acknowledgement << " packets with window " << requestHeader.GetWindow());
+	int lastPacket = std::min(session.acknowledgements + requestHeader.GetWindow(), NUMBER_OF_PACKETS_TO_SEND);
+	while(session.packets < lastPacket) {
+		SendData(requestHeader, session.packets);
+		session.packets += 1;
+	}
+	if(session.packets > session.acknowledgements && !session.resend.IsRunning()) {
+		NS_LOG_DEBUG(localAddress << " -> Schedule retransmission of data packet " << session.acknowledgements);
+		session.resend = Simulator::Schedule(Seconds(retransmissionTimer.GetTimeout(requester.first, 0)), &ServiceApplication::Retry, this, CreateDataPacket(requestHeader, session.acknowledgements), 1, requester, requestHeader.GetSenderAddress().Get());
+	}
+	NS_LOG_DEBUG(localAddress << " -> Setting up cancel timer");
+	session.timer = Simulator::Schedule(Seconds(retransmissionTimer.GetExpirationTime(requester.first)), &ServiceApplication::CancelService, this, requester);
 }
 
 void ServiceApplication::SendRequest(ServiceRequestResponseHeader requestHeader) {
 	NS_LOG_FUNCTION(this << requestHeader);
-	std::pair<uint, std::string> key = GetDestinationKey(requestHeader);
+	SESSION_KEY key = GetDestinationKey(requestHeader);
+	SERVICE_SESSION &session = sessions.Get(key);
 	Ptr<Packet> packet = Create<Packet>(PACKET_LENGTH);
 	packet->AddHeader(requestHeader);
 	TypeHeader typeHeader(STRATOS_SERVICE_REQUEST);
 	packet->AddHeader(typeHeader);
 	NS_LOG_DEBUG(localAddress << " -> Schedule request to send");
 	Simulator::Schedule(Seconds(Utilities::GetJitter()), &ServiceApplication::SendUnicastMessage, this, packet, requestHeader.GetDestinationAddress().Get());
+	session.transmission = retransmissionTimer.Send();
+	session.inFlight = true;
 	NS_LOG_DEBUG(localAddress << " -> Schedule next retry");
-	resends[GetDestinationKey(requestHeader)] = Simulator::Schedule(Seconds(MAX_RESPONSE_WAIT_TIME), &ServiceApplication::Retry, this, packet, 1, GetDestinationKey(requestHeader), requestHeader.GetDestinationAddress().Get());
+	session.resend = Simulator::Schedule(Seconds(retransmissionTimer.GetTimeout(key.first, 0)), &ServiceApplication::Retry, this, packet, 1, key, requestHeader.GetDestinationAddress().Get());
 	NS_LOG_DEBUG(localAddress << " -> Setting up cancel timer");
-	timers[key] = Simulator::Schedule(Seconds(MAX_RESPONSE_WAIT_TIME * (MAX_TRIES + 1)), &ServiceApplication::CancelService, this, key);
+	session.timer = Simulator::Schedule(Seconds(retransmissionTimer.GetExpirationTime(key.first)), &ServiceApplication::CancelService, this, key);
 }
 
 void ServiceApplication::CreateAndSendRequest(ServiceRequestResponseHeader response, Flag flag) {
@@ -233,11 +351,14 @@ void ServiceApplication::CreateAndSendRequest(ServiceRequestResponseHeader respo
 
 ServiceRequestResponseHeader ServiceApplication::CreateRequest(ServiceRequestResponseHeader response, Flag flag) {
 	NS_LOG_FUNCTION(this << response << flag);
+	SERVICE_SESSION &session = sessions.Get(GetSenderKey(response));
 	ServiceRequestResponseHeader request;
 	request.SetFlag(flag);
 	request.SetSenderAddress(localAddress);
 	request.SetService(response.GetService());
 	request.SetDestinationAddress(response.GetSenderAddress());
+	request.SetAcknowledgement(session.packets);
+	request.SetWindow(std::max(1, std::min(session.window, session.maxPackets - session.packets)));
 	NS_LOG_DEBUG(localAddress << " -> Request created: " << request);
 	return request;
 }
@@ -246,6 +367,7 @@ ServiceRequestResponseHeader ServiceApplication::CreateRequest(Ipv4Address desti
 	NS_LOG_FUNCTION(this << destinationAddress << service);
 	ServiceRequestResponseHeader request;
 	request.SetService(service);
+	request.SetWindow(WINDOW_SIZE);
 	request.SetFlag(STRATOS_START_SERVICE);
 	request.SetSenderAddress(localAddress);
 	request.SetDestinationAddress(destinationAddress);
@@ -258,7 +380,7 @@ void ServiceApplication::ReceiveError(Ptr<Packet> packet) {
 	ServiceErrorHeader errorHeader;
 	packet->RemoveHeader(errorHeader);
 	NS_LOG_DEBUG(localAddress << " -> Error received: " << errorHeader);
-	std::pair<uint, std::string> key = GetSenderKey(errorHeader);
+	SESSION_KEY key = GetSenderKey(errorHeader);
 	NS_LOG_DEBUG(localAddress << " -> Cancelling service [" << key.first << ", " << key.second << "]");
 	CancelService(key);
 }
@@ -294,17 +416,22 @@ void ServiceApplication::ReceiveResponse(Ptr<Packet> packet) {
 	packet->RemoveHeader(responseHeader);
 	NS_LOG_DEBUG(localAddress << " -> Received response " << responseHeader);
 	Flag flag;
-	std::pair<uint, std::string> responser = GetSenderKey(responseHeader);
-	Simulator::Cancel(timers[responser]);
-	Simulator::Cancel(resends[responser]);
-	Flag currentStatus = status[responser];
+	SESSION_KEY responser = GetSenderKey(responseHeader);
+	AcknowledgeTransmission(responser);
+	SERVICE_SESSION *session = sessions.Find(responser);
+	Flag currentStatus = STRATOS_NULL;
+	if(session != NULL) {
+		Simulator::Cancel(session->timer);
+		Simulator::Cancel(session->resend);
+		currentStatus = session->status;
+	}
 	NS_LOG_DEBUG(localAddress << " -> Service for [" << responser.first << ", " << responser.second << "] is in state " << currentStatus);
 	NS_LOG_DEBUG(localAddress << " -> Response [" << responser.first << ", " << responser.second << "] has flag " << responseHeader.GetFlag());
 	switch(responseHeader.GetFlag()) {
 		case STRATOS_SERVICE_STARTED:
 			if(currentStatus == STRATOS_START_SERVICE) {
 				flag = STRATOS_DO_SERVICE;
-				status[responser] = STRATOS_DO_SERVICE;
+				session->status = STRATOS_DO_SERVICE;
 				NS_LOG_DEBUG(localAddress << " -> Service for [" << responser.first << ", " << responser.second << "] changes to state " << STRATOS_DO_SERVICE);
 				CreateAndSendRequest(responseHeader, flag);
 			} else {
@@ -313,16 +440,18 @@ void ServiceApplication::ReceiveResponse(Ptr<Packet> packet) {
 			}
 		break;
 		case STRATOS_DO_SERVICE:
-			if(currentStatus == STRATOS_DO_SERVICE) {
-				if((packets[responser] + 1) <= maxPackets[responser]) {
+			if(currentStatus == STRATOS_DO_SERVICE && session->window > 1) {
+				ReceiveData(responseHeader);
+			} else if(currentStatus == STRATOS_DO_SERVICE) {
+				if((session->packets + 1) <= session->maxPackets) {
 					flag = STRATOS_DO_SERVICE;
-					packets[responser] += 1;
-					resultsManager->AddPacket(Now().GetMilliSeconds());
+					session->packets += 1;
+					resultsManager->AddPacket(Now().GetMilliSeconds(), responser.first);
 					NS_LOG_DEBUG(localAddress << " -> Received data packet from [" << responser.first << ", " << responser.second << "]");
 				}
-				if(packets[responser] >= maxPackets[responser]) {
+				if(session->packets >= session->maxPackets) {
 					flag = STRATOS_STOP_SERVICE;
-					status[responser] = STRATOS_STOP_SERVICE;
+					session->status = STRATOS_STOP_SERVICE;
 					NS_LOG_DEBUG(localAddress << " -> All data received from [" << responser.first << ", " << responser.second << "]");
 					NS_LOG_DEBUG(localAddress << " -> Service for [" << responser.first << ", " << responser.second << "] changes to state " << STRATOS_STOP_SERVICE);
 				}
@@ -333,28 +462,73 @@ void ServiceApplication::ReceiveResponse(Ptr<Packet> packet) {
 			}
 		break;
 		case STRATOS_SERVICE_STOPPED:
-			status[responser] = STRATOS_SERVICE_STOPPED;
 			NS_LOG_DEBUG(localAddress << " -> Service for [" << responser.first << ", " << responser.second << "] changes to state " << STRATOS_SERVICE_STOPPED);
 			CancelService(responser);
 		break;
 		default:
 			NS_LOG_WARN(localAddress << " -> Request [" << responser.first << ", " << responser.second << "] has unknown flag " << responseHeader.GetFlag());
 	}
+	ReleaseIdleSession(responser);
+}
+
+void ServiceApplication::ReceiveData(ServiceRequestResponseHeader responseHeader) {
+	NS_LOG_FUNCTION(this << responseHeader);
+	Flag flag = STRATOS_DO_SERVICE;
+	SESSION_KEY responser = GetSenderKey(responseHeader);
+	SERVICE_SESSION &session = sessions.Get(responser);
+	int sequence = responseHeader.GetSequence();
+	if(sequence >= session.packets && sequence < session.maxPackets && session.outOfOrderPackets.insert(sequence).second) {
+		resultsManager->AddPacket(Now().GetMilliSeconds(), responser.first);
+		NS_LOG_DEBUG(localAddress << " -> Received data packet " << sequence << " from [" << responser.first << ", " << responser.second << "]");
+		while(session.outOfOrderPackets.erase(session.packets) > 0) {
+			session.packets += 1;
+		}
+	}
+	if(session.packets >= session.maxPackets) {
+		flag = STRATOS_STOP_SERVICE;
+		session.status = STRATOS_STOP_SERVICE;
+		NS_LOG_DEBUG(localAddress << " -> All data received from [" << responser.first << ", " << responser.second << "]");
+		NS_LOG_DEBUG(localAddress << " -> Service for [" << responser.first << ", " << responser.second << "] changes to state " << STRATOS_STOP_SERVICE);
+	}
+	CreateAndSendRequest(responseHeader, flag);
 }
 
 void ServiceApplication::SendResponse(ServiceRequestResponseHeader responseHeader) {
 	NS_LOG_FUNCTION(this << responseHeader);
-	std::pair<uint, std::string> key = GetDestinationKey(responseHeader);
-	Ptr<Packet> packet = Create<Packet>(PACKET_LENGTH);
-	packet->AddHeader(responseHeader);
-	TypeHeader typeHeader(STRATOS_SERVICE_RESPONSE);
-	packet->AddHeader(typeHeader);
+	SESSION_KEY key = GetDestinationKey(responseHeader);
+	SERVICE_SESSION &session = sessions.Get(key);
+	Ptr<Packet> packet = CreateResponsePacket(responseHeader);
 	NS_LOG_DEBUG(localAddress << " -> Schedule response to send");
 	Simulator::Schedule(Seconds(Utilities::GetJitter()), &ServiceApplication::SendUnicastMessage, this, packet, responseHeader.GetDestinationAddress().Get());
+	session.transmission = retransmissionTimer.Send();
+	session.inFlight = true;
 	NS_LOG_DEBUG(localAddress << " -> Schedule next retry");
-	resends[key] = Simulator::Schedule(Seconds(MAX_RESPONSE_WAIT_TIME), &ServiceApplication::Retry, this, packet, 1, key, responseHeader.GetDestinationAddress().Get());
+	session.resend = Simulator::Schedule(Seconds(retransmissionTimer.GetTimeout(key.first, 0)), &ServiceApplication::Retry, this, packet, 1, key, responseHeader.GetDestinationAddress().Get());
 	NS_LOG_DEBUG(localAddress << " -> Setting up cancel timer");
-	timers[key] = Simulator::Schedule(Seconds(MAX_RESPONSE_WAIT_TIME * (MAX_TRIES + 1)), &ServiceApplication::CancelService, this, key);
+	session.timer = Simulator::Schedule(Seconds(retransmissionTimer.GetExpirationTime(key.first)), &ServiceApplication::CancelService, this, key);
+}
+
+void ServiceApplication::SendData(ServiceRequestResponseHeader request, int sequence) {
+	NS_LOG_FUNCTION(this << request << sequence);
+	Ptr<Packet> packet = CreateDataPacket(request, sequence);
+	NS_LOG_DEBUG(localAddress << " -> Schedule data packet " << sequence << " to send");
+	Simulator::Schedule(Seconds(Utilities::GetJitter()), &ServiceApplication::SendUnicastMessage, this, packet, request.GetSenderAddress().Get());
+}
+
+Ptr<Packet> ServiceApplication::CreateResponsePacket(ServiceRequestResponseHeader responseHeader) {
+	NS_LOG_FUNCTION(this << responseHeader);
+	Ptr<Packet> packet = Create<Packet>(PACKET_LENGTH);
+	packet->AddHeader(responseHeader);
+	TypeHeader typeHeader(STRATOS_SERVICE_RESPONSE);
+	packet->AddHeader(typeHeader);
+	return packet;
+}
+
+Ptr<Packet> ServiceApplication::CreateDataPacket(ServiceRequestResponseHeader request, int sequence) {
+	NS_LOG_FUNCTION(this << request << sequence);
+	ServiceRequestResponseHeader response = CreateResponse(request, STRATOS_DO_SERVICE);
+	response.SetSequence(sequence);
+	return CreateResponsePacket(response);
 }
 
 void ServiceApplication::CreateAndSendResponse(ServiceRequestResponseHeader request, Flag flag) {
@@ -3,8 +3,10 @@
 
 #include "ns3/internet-module.h"
 
+#include "session-table.h"
 #include "application-helper.h"
 #include "results-application.h"
+#include "retransmission-timer.h"
 #include "service-error-header.h"
 #include "ontology-application.h"
 #include "service-request-response-header.h"
@@ -28,31 +30,34 @@ class ServiceApplication : public Application {
 		virtual void StopApplication();
 
 	public:
+		int WINDOW_SIZE;
+		bool ADAPTIVE_TIMERS;
 		int NUMBER_OF_PACKETS_TO_SEND;
-		void SetCallback(Callback<void> continueScheduleCallback);
+		void SetCallback(Callback<void, Ipv4Address, int> continueScheduleCallback);
+		bool AddPackets(Ipv4Address destinationAddress, std::string service, int extraPackets);
 		void CreateAndSendRequest(Ipv4Address destinationAddress, std::string service, int packets);
 
 	private:
 		Ptr<Socket> socket;
 		Ipv4Address localAddress;
 		Ptr<ResultsApplication> resultsManager;
-		Callback<void> continueScheduleCallback;
+		Callback<void, Ipv4Address, int> continueScheduleCallback;
 		Ptr<OntologyApplication> ontologyManager;
-		std::map<std::pair<uint, std::string>, Flag> status;
-		std::map<std::pair<uint, std::string>, int> packets;
-		std::map<std::pair<uint, std::string>, int> maxPackets;
-		std::map<std::pair<uint, std::string>, EventId> timers;
-		std::map<std::pair<uint, std::string>, EventId> resends;
+		SessionTable sessions;
+		RetransmissionTimer retransmissionTimer;
 
 		void ReceiveMessage(Ptr<Socket> socket);
-		void CancelService(std::pair<uint, std::string> key);
+		void CancelService(SESSION_KEY key);
+		void ReleaseIdleSession(SESSION_KEY key);
+		void AcknowledgeTransmission(SESSION_KEY key);
 		void SendUnicastMessage(Ptr<Packet> packet, uint destinationAddress);
-		std::pair<uint, std::string> GetSenderKey(ServiceErrorHeader errorHeader);
-		std::pair<uint, std::string> GetSenderKey(ServiceRequestResponseHeader requestResponse);
-		std::pair<uint, std::string> GetDestinationKey(ServiceRequestResponseHeader requestResponse);
-		void Retry(Ptr<Packet> packet, int nTry, std::pair<uint, std::string> key, uint destinationAddress);
+		SESSION_KEY GetSenderKey(ServiceErrorHeader errorHeader);
+		SESSION_KEY GetSenderKey(ServiceRequestResponseHeader requestResponse);
+		SESSION_KEY GetDestinationKey(ServiceRequestResponseHeader requestResponse);
+		void Retry(Ptr<Packet> packet, int nTry, SESSION_KEY key, uint destinationAddress);
 
 		void ReceiveRequest(Ptr<Packet> packet);
+		void ReceiveAcknowledgement(ServiceRequestResponseHeader requestHeader);
 		void SendRequest(ServiceRequestResponseHeader requestHeader);
 		void CreateAndSendRequest(ServiceRequestResponseHeader response, Flag flag);
 		ServiceRequestResponseHeader CreateRequest(ServiceRequestResponseHeader response, Flag flag);
@@ -64,7 +69,11 @@ class ServiceApplication : public Application {
 		ServiceErrorHeader CreateError(ServiceRequestResponseHeader requestResponse);
 
 		void ReceiveResponse(Ptr<Packet> packet);
+		void ReceiveData(ServiceRequestResponseHeader responseHeader);
 		void SendResponse(ServiceRequestResponseHeader responseHeader);
+		void SendData(ServiceRequestResponseHeader request, int sequence);
+		Ptr<Packet> CreateResponsePacket(ServiceRequestResponseHeader responseHeader);
+		Ptr<Packet> CreateDataPacket(ServiceRequestResponseHeader request, int sequence);
 		void CreateAndSendResponse(ServiceRequestResponseHeader request, Flag flag);
 		ServiceRequestResponseHeader CreateResponse(ServiceRequestResponseHeader request, Flag flag);
 };
@@ -0,0 +1,183 @@
+#include "service-catalog.h"
+
+#include "ns3/core-module.h"
+
+#include "service-path.h"
+
+#include <fstream>
+
+NS_LOG_COMPONENT_DEFINE("ServiceCatalog");
+
+const std::string ServiceCatalog::SERVICES[] = {"0", "00", "000", "0000", "00000", "00001", "0001", "0002", "00020", "00021", "00022", "0003", "00030", "00031", "001", "0010", "00100", "0011", "00110", "00111", "01", "010", "0100", "01000", "0101", "01010", "01011", "01012", "01013", "011", "0110", "02", "020", "021", "022", "023"};
+
+const int ServiceCatalog::TOTAL_NUMBER_OF_SERVICES = BUILT_IN_NUMBER_OF_SERVICES;
+
+int ServiceCatalog::size = 0;
+
+std::vector<int> ServiceCatalog::distanceTable;
+
+std::map<std::string, int> ServiceCatalog::ids;
+
+std::vector<std::string> ServiceCatalog::services;
+
+std::vector<SERVICE_PATH> ServiceCatalog::paths;
+
+std::vector<char> ServiceCatalog::packed;
+
+pthread_once_t ServiceCatalog::initialized = PTHREAD_ONCE_INIT;
+
+/*
+ * The distances of the built-in catalog are computed from SERVICES the first time they are needed,
+ * the same way as those of a loaded catalog, so they can not fall out of date.
+ */
+void ServiceCatalog::Initialize() {
+	NS_LOG_FUNCTION_NOARGS();
+	Build(std::vector<std::string>(SERVICES, SERVICES + TOTAL_NUMBER_OF_SERVICES));
+}
+
+/*
+ * The central server matches from several threads at once, so the first of them to need the catalog
+ * builds it while the others wait, and none of them ever sees it half filled.
+ */
+void ServiceCatalog::EnsureInitialized() {
+	pthread_once(&initialized, &ServiceCatalog::Initialize);
+}
+
+std::string ServiceCatalog::GetCommonPrefix(std::string requiredService, std::string offeredService) {
+	NS_LOG_FUNCTION(requiredService << offeredService);
+	int minLength = requiredService.length() > offeredService.length() ? offeredService.length() : requiredService.length();
+	NS_LOG_INFO("Shorter string between " << requiredService << " and " << offeredService << " is " << (requiredService.length() > offeredService.length() ? offeredService : requiredService));
+	std::string commonPrefix;
+	for(int i = 0; i < minLength; i++) {
+		if(requiredService.at(i) == offeredService.at(i)) {
+			commonPrefix.push_back(requiredService.at(i));
+		} else {
+			break;
+		}
+	}
+	NS_LOG_DEBUG(requiredService << " and " << offeredService << " common prefix is " << commonPrefix);
+	return commonPrefix;
+}
+
+int ServiceCatalog::GetSize() {
+	EnsureInitialized();
+	return size;
+}
+
+/*
+ * Replaces the built-in catalog, which is built first so it can never overwrite the loaded one.
+ */
+void ServiceCatalog::Load(std::vector<std::string> catalog) {
+	NS_LOG_FUNCTION(catalog.size());
+	EnsureInitialized();
+	Build(catalog);
+}
+
+/*
+ * The distance table grows with the square of the catalog, so rows of services that can be packed
+ * are scored in a batch and only the pairs involving an unpackable service are compared as strings.
+ */
+void ServiceCatalog::Build(std::vector<std::string> catalog) {
+	NS_LOG_FUNCTION(catalog.size());
+	ids.clear();
+	services = catalog;
+	size = services.size();
+	distanceTable.resize(size * size);
+	paths.assign(size, SERVICE_PATH());
+	packed.assign(size, false);
+	bool allPacked = true;
+	for(int i = 0; i < size; i++) {
+		ids[services[i]] = i;
+		packed[i] = ServicePath::Pack(services[i], paths[i]);
+		allPacked = allPacked && packed[i];
+	}
+	for(int i = 0; i < size; i++) {
+		if(allPacked) {
+			ServicePath::SemanticDistances(paths[i], &paths[0], size, &distanceTable[i * size]);
+			continue;
+		}
+		for(int j = 0; j < size; j++) {
+			if(packed[i] && packed[j]) {
+				distanceTable[i * size + j] = ServicePath::SemanticDistance(paths[i], paths[j]);
+			} else {
+				distanceTable[i * size + j] = CalculateSemanticDistance(services[i], services[j]);
+			}
+		}
+	}
+	NS_LOG_DEBUG("Loaded a catalog of " << size << " services");
+}
+
+void ServiceCatalog::LoadFromFile(std::string path) {
+	NS_LOG_FUNCTION(path);
+	std::ifstream file(path.c_str());
+	if(!file.is_open()) {
+		NS_FATAL_ERROR("Unable to open service catalog " << path);
+	}
+	std::string service;
+	std::vector<std::string> catalog;
+	while(file >> service) {
+		catalog.push_back(service);
+	}
+	Load(catalog);
+}
+
+int ServiceCatalog::GetServiceId(std::string service) {
+	NS_LOG_FUNCTION(service);
+	EnsureInitialized();
+	std::map<std::string, int>::iterator i = ids.find(service);
+	if(i == ids.end()) {
+		NS_LOG_DEBUG("Service " << service << " is not in the catalog");
+		return UNKNOWN_SERVICE;
+	}
+	return i->second;
+}
+
+const std::string & ServiceCatalog::GetService(int serviceId) {
+	NS_LOG_FUNCTION(serviceId);
+	EnsureInitialized();
+	return services.at(serviceId);
+}
+
+/*
+ * Packed path of a service of the catalog, packed once when the catalog was built. False if it could not be.
+ */
+bool ServiceCatalog::GetServicePath(int serviceId, SERVICE_PATH &path) {
+	path = paths[serviceId];
+	return packed[serviceId];
+}
+
+std::vector<int> ServiceCatalog::GetServiceIds(std::list<std::string> services) {
+	NS_LOG_FUNCTION(&services);
+	std::vector<int> serviceIds;
+	serviceIds.reserve(services.size());
+	for(std::list<std::string>::iterator i = services.begin(); i != services.end(); i++) {
+		serviceIds.push_back(GetServiceId(*i));
+	}
+	return serviceIds;
+}
+
+/*
+ * Ids only come from the catalog, which was initialized to hand them out.
+ */
+int ServiceCatalog::SemanticDistance(int requiredService, int offeredService) {
+	return distanceTable[requiredService * size + offeredService];
+}
+
+int ServiceCatalog::CalculateSemanticDistance(std::string requiredService, std::string offeredService) {
+	NS_LOG_FUNCTION(requiredService << offeredService);
+	if(offeredService.compare(requiredService) == 0) {
+		NS_LOG_DEBUG(requiredService << " - " << offeredService << " = 0, they are the same service");
+		return 0;
+	}
+	std::string commonPrefix = GetCommonPrefix(requiredService, offeredService);
+	if(offeredService.compare(commonPrefix) == 0) {
+		NS_LOG_DEBUG(offeredService << " - " << commonPrefix << " = 0, " << offeredService << " is the first common ancestor with " << requiredService);
+		return 0;
+	}
+	int distanceFromOfferedToCommon = offeredService.length() - commonPrefix.length();
+	NS_LOG_DEBUG(offeredService << " - " << commonPrefix << " = " << distanceFromOfferedToCommon);
+	int distanceFromRequiredToCommon = requiredService.length() - commonPrefix.length();
+	NS_LOG_DEBUG(requiredService << " - " << commonPrefix << " = " << distanceFromRequiredToCommon);
+	NS_LOG_DEBUG(requiredService << " - " << offeredService << " = " << (distanceFromOfferedToCommon > distanceFromRequiredToCommon ? distanceFromOfferedToCommon : distanceFromRequiredToCommon));
+	return distanceFromOfferedToCommon > distanceFromRequiredToCommon ? distanceFromOfferedToCommon : distanceFromRequiredToCommon;
+}
\ No newline at end of file
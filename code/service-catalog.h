@@ -0,0 +1,45 @@
+#ifndef SERVICE_CATALOG_H
+#define SERVICE_CATALOG_H
+
+#include <map>
+#include <list>
+#include <vector>
+#include <string>
+#include <pthread.h>
+
+#include "definitions.h"
+
+class ServiceCatalog {
+
+	private:
+		static const std::string SERVICES[];
+		static const int TOTAL_NUMBER_OF_SERVICES;
+
+		static int size;
+		static std::vector<int> distanceTable;
+		static std::map<std::string, int> ids;
+		static std::vector<std::string> services;
+		static std::vector<SERVICE_PATH> paths;
+		static std::vector<char> packed;
+		static pthread_once_t initialized;
+
+		static void Initialize();
+		static void EnsureInitialized();
+		static void Build(std::vector<std::string> catalog);
+		static std::string GetCommonPrefix(std::string requiredService, std::string offeredService);
+
+	public:
+		static int GetSize();
+		static void Load(std::vector<std::string> catalog);
+		static void LoadFromFile(std::string path);
+
+		static int GetServiceId(std::string service);
+		static const std::string & GetService(int serviceId);
+		static bool GetServicePath(int serviceId, SERVICE_PATH &path);
+		static std::vector<int> GetServiceIds(std::list<std::string> services);
+
+		static int SemanticDistance(int requiredService, int offeredService);
+		static int CalculateSemanticDistance(std::string requiredService, std::string offeredService);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,92 @@
+#include "service-codec.h"
+
+#include <algorithm>
+
+#include "service-catalog.h"
+
+int ServiceCodec::GetServiceId(std::string service) {
+	int serviceId = ServiceCatalog::GetServiceId(service);
+	if(serviceId >= SERVICE_STRING_ID) {
+		return UNKNOWN_SERVICE;
+	}
+	return serviceId;
+}
+
+std::string ServiceCodec::GetService(int serviceId, const std::string &service) {
+	if(serviceId == UNKNOWN_SERVICE) {
+		return service;
+	}
+	return ServiceCatalog::GetService(serviceId);
+}
+
+uint32_t ServiceCodec::GetSerializedSize(int serviceId, uint32_t serviceLength) {
+	if(serviceId == UNKNOWN_SERVICE) {
+		return 4 + serviceLength;
+	}
+	return 2;
+}
+
+uint32_t ServiceCodec::GetSerializedSize(int serviceId, const std::string &service) {
+	return GetSerializedSize(serviceId, service.length());
+}
+
+/*
+ * Size of the service field at i, or 0 when the bytes left can not hold it.
+ */
+uint32_t ServiceCodec::PeekSerializedSize(Buffer::Iterator i) {
+	if(i.GetRemainingSize() < 2) {
+		return 0;
+	}
+	if(i.ReadU16() != SERVICE_STRING_ID) {
+		return 2;
+	}
+	if(i.GetRemainingSize() < 2) {
+		return 0;
+	}
+	uint16_t serviceLength = i.ReadU16();
+	return i.GetRemainingSize() < serviceLength ? 0 : 4 + serviceLength;
+}
+
+void ServiceCodec::Serialize(Buffer::Iterator &serializer, int serviceId, const char *service, uint16_t serviceLength) {
+	if(serviceId != UNKNOWN_SERVICE) {
+		serializer.WriteU16(serviceId);
+		return;
+	}
+	serializer.WriteU16(SERVICE_STRING_ID);
+	serializer.WriteU16(serviceLength);
+	serializer.Write((const uint8_t *) service, serviceLength);
+}
+
+void ServiceCodec::Serialize(Buffer::Iterator &serializer, int serviceId, const std::string &service) {
+	Serialize(serializer, serviceId, service.data(), service.length());
+}
+
+/*
+ * Only the first capacity bytes of a name are copied and the rest skipped, so the iterator always
+ * ends after the field. serviceLength is the length on the wire, callers compare it with capacity.
+ */
+int ServiceCodec::Deserialize(Buffer::Iterator &i, char *service, uint16_t &serviceLength, uint16_t capacity) {
+	int serviceId = i.ReadU16();
+	serviceLength = 0;
+	if(serviceId != SERVICE_STRING_ID) {
+		return serviceId < ServiceCatalog::GetSize() ? serviceId : UNKNOWN_SERVICE;
+	}
+	serviceLength = i.ReadU16();
+	uint16_t copied = std::min(serviceLength, capacity);
+	i.Read((uint8_t *) service, copied);
+	i.Next(serviceLength - copied);
+	return UNKNOWN_SERVICE;
+}
+
+int ServiceCodec::Deserialize(Buffer::Iterator &i, std::string &service) {
+	int serviceId = i.ReadU16();
+	if(serviceId != SERVICE_STRING_ID) {
+		service.clear();
+		return serviceId < ServiceCatalog::GetSize() ? serviceId : UNKNOWN_SERVICE;
+	}
+	service.resize(i.ReadU16());
+	if(!service.empty()) {
+		i.Read((uint8_t *) &service[0], service.length());
+	}
+	return UNKNOWN_SERVICE;
+}
\ No newline at end of file
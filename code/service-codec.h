@@ -0,0 +1,32 @@
+#ifndef SERVICE_CODEC_H
+#define SERVICE_CODEC_H
+
+#include "ns3/header.h"
+
+#include <string>
+
+#include "definitions.h"
+
+using namespace ns3;
+
+/*
+ * Headers carry services as their 16-bit catalog id, so both ends must load the same catalog.
+ * Services outside it are sent as SERVICE_STRING_ID followed by their length prefixed name,
+ * which is the only case where a header keeps the name itself.
+ */
+class ServiceCodec {
+
+	public:
+		static int GetServiceId(std::string service);
+		static std::string GetService(int serviceId, const std::string &service);
+
+		static uint32_t GetSerializedSize(int serviceId, uint32_t serviceLength);
+		static uint32_t GetSerializedSize(int serviceId, const std::string &service);
+		static uint32_t PeekSerializedSize(Buffer::Iterator i);
+		static void Serialize(Buffer::Iterator &serializer, int serviceId, const char *service, uint16_t serviceLength);
+		static void Serialize(Buffer::Iterator &serializer, int serviceId, const std::string &service);
+		static int Deserialize(Buffer::Iterator &i, char *service, uint16_t &serviceLength, uint16_t capacity);
+		static int Deserialize(Buffer::Iterator &i, std::string &service);
+};
+
+#endif
\ No newline at end of file
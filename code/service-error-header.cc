@@ -3,6 +3,7 @@
 #include "ns3/address-utils.h"
 
 #include "utilities.h"
+#include "service-codec.h"
 
 TypeId ServiceErrorHeader::GetTypeId() {
 	static TypeId typeId = TypeId("ServiceErrorHeader")
@@ -16,24 +17,18 @@ TypeId ServiceErrorHeader::GetInstanceTypeId() const {
 }
 
 uint32_t ServiceErrorHeader::GetSerializedSize() const {
-	return 10 + serviceSize;
+	return 8 + ServiceCodec::GetSerializedSize(serviceId, service);
 }
 
 void ServiceErrorHeader::Print(std::ostream &stream) const {
-	stream << "Service error sent from " << senderAddress << " to " << destinationAddress << " for service " << service << ".";
+	stream << "Service error sent from " << senderAddress << " to " << destinationAddress << " for service " << ServiceCodec::GetService(serviceId, service) << ".";
 }
 
 uint32_t ServiceErrorHeader::Deserialize(Buffer::Iterator start) {
 	Buffer::Iterator i = start;
 	ReadFrom(i, senderAddress);
 	ReadFrom(i, destinationAddress);
-	serviceSize = i.ReadU16();
-	char tmp[serviceSize + 1];
-	for(int j = 0; j < serviceSize; j++) {
-		tmp[j] = i.ReadU8();
-	}
-	tmp[serviceSize] = '\0';
-	service = std::string(tmp);
+	serviceId = ServiceCodec::Deserialize(i, service);
 	uint32_t size = i.GetDistanceFrom(start);
 	return size;
 }
@@ -41,21 +36,22 @@ uint32_t ServiceErrorHeader::Deserialize(Buffer::Iterator start) {
 void ServiceErrorHeader::Serialize(Buffer::Iterator serializer) const {
 	WriteTo(serializer, senderAddress);
 	WriteTo(serializer, destinationAddress);
-	serializer.WriteU16(serviceSize);
-	for(int i = 0; i < serviceSize; i++) {
-		serializer.WriteU8(service.at(i));
-	}
+	ServiceCodec::Serialize(serializer, serviceId, service);
 }
 
 ServiceErrorHeader::ServiceErrorHeader() {
 	service = "0";
-	serviceSize = 1;
+	serviceId = UNKNOWN_SERVICE;
 	senderAddress = Ipv4Address::GetAny();
 	destinationAddress = Ipv4Address::GetAny();
 }
 
 std::string ServiceErrorHeader::GetService() {
-	return service;
+	return ServiceCodec::GetService(serviceId, service);
+}
+
+int ServiceErrorHeader::GetServiceId() {
+	return serviceId;
 }
 
 Ipv4Address ServiceErrorHeader::GetSenderAddress() {
@@ -67,8 +63,8 @@ Ipv4Address ServiceErrorHeader::GetDestinationAddress() {
 }
 
 void ServiceErrorHeader::SetService(std::string service) {
-	this->service = service;
-	serviceSize = service.length();
+	serviceId = ServiceCodec::GetServiceId(service);
+	this->service = serviceId == UNKNOWN_SERVICE ? service : std::string();
 }
 
 void ServiceErrorHeader::SetSenderAddress(Ipv4Address senderAddress) {
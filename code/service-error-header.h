@@ -19,7 +19,7 @@ class ServiceErrorHeader : public Header {
 		virtual void Serialize(Buffer::Iterator serializer) const;
 
 	private:
-		int serviceSize;
+		int serviceId;
 
 		std::string service;
 		Ipv4Address senderAddress;
@@ -29,6 +29,7 @@ class ServiceErrorHeader : public Header {
 		ServiceErrorHeader();
 
 		std::string GetService();
+		int GetServiceId();
 		Ipv4Address GetSenderAddress();
 		Ipv4Address GetDestinationAddress();
 
@@ -0,0 +1,80 @@
+#include "service-index.h"
+
+#include "ns3/core-module.h"
+
+NS_LOG_COMPONENT_DEFINE("ServiceIndex");
+
+static const std::set<uint> NO_NODES;
+
+/*
+ * The first depth digits of the service, with the depth in the last nibble, which is never a digit.
+ */
+uint64_t ServiceIndex::GetKey(SERVICE_PATH service, int depth) {
+	uint64_t mask = depth == 0 ? 0 : ~(uint64_t) 0 << (64 - 4 * depth);
+	return (service.digits & mask) | depth;
+}
+
+/*
+ * Services are NULL when they could not be packed. Every prefix but the root is indexed, as the
+ * root would only list every node again.
+ */
+void ServiceIndex::Add(uint node, const SERVICE_PATH *services, int nServices) {
+	NS_LOG_FUNCTION(this << node << nServices);
+	if(services == NULL) {
+		unpacked.insert(node);
+		return;
+	}
+	for(int i = 0; i < nServices; i++) {
+		providers[GetKey(services[i], services[i].depth)].insert(node);
+		for(int depth = 1; depth <= services[i].depth; depth++) {
+			prefixProviders[GetKey(services[i], depth)].insert(node);
+		}
+	}
+}
+
+void ServiceIndex::Remove(uint node, const SERVICE_PATH *services, int nServices) {
+	NS_LOG_FUNCTION(this << node << nServices);
+	if(services == NULL) {
+		unpacked.erase(node);
+		return;
+	}
+	std::map<uint64_t, std::set<uint> >::iterator list;
+	for(int i = 0; i < nServices; i++) {
+		list = providers.find(GetKey(services[i], services[i].depth));
+		if(list != providers.end()) {
+			list->second.erase(node);
+			if(list->second.empty()) {
+				providers.erase(list);
+			}
+		}
+		for(int depth = 1; depth <= services[i].depth; depth++) {
+			list = prefixProviders.find(GetKey(services[i], depth));
+			if(list != prefixProviders.end()) {
+				list->second.erase(node);
+				if(list->second.empty()) {
+					prefixProviders.erase(list);
+				}
+			}
+		}
+	}
+}
+
+/*
+ * Nodes offering exactly the first depth levels of the service.
+ */
+const std::set<uint> & ServiceIndex::GetProviders(SERVICE_PATH service, int depth) const {
+	std::map<uint64_t, std::set<uint> >::const_iterator list = providers.find(GetKey(service, depth));
+	return list == providers.end() ? NO_NODES : list->second;
+}
+
+/*
+ * Nodes offering a service that shares at least the first depth levels of the service.
+ */
+const std::set<uint> & ServiceIndex::GetProvidersUnder(SERVICE_PATH service, int depth) const {
+	std::map<uint64_t, std::set<uint> >::const_iterator list = prefixProviders.find(GetKey(service, depth));
+	return list == prefixProviders.end() ? NO_NODES : list->second;
+}
+
+const std::set<uint> & ServiceIndex::GetUnpacked() const {
+	return unpacked;
+}
\ No newline at end of file
@@ -0,0 +1,32 @@
+#ifndef SERVICE_INDEX_H
+#define SERVICE_INDEX_H
+
+#include <map>
+#include <set>
+#include <stdint.h>
+
+#include "definitions.h"
+
+/*
+ * Posting lists of the nodes offering each service and of the nodes offering any service under
+ * each ontology prefix, keyed by packed path. Nodes with services that can not be packed are kept
+ * apart, since their semantic distances are not bounded by their prefixes.
+ */
+class ServiceIndex {
+
+	private:
+		std::map<uint64_t, std::set<uint> > providers;
+		std::map<uint64_t, std::set<uint> > prefixProviders;
+		std::set<uint> unpacked;
+
+		static uint64_t GetKey(SERVICE_PATH service, int depth);
+
+	public:
+		void Add(uint node, const SERVICE_PATH *services, int nServices);
+		void Remove(uint node, const SERVICE_PATH *services, int nServices);
+		const std::set<uint> & GetProviders(SERVICE_PATH service, int depth) const;
+		const std::set<uint> & GetProvidersUnder(SERVICE_PATH service, int depth) const;
+		const std::set<uint> & GetUnpacked() const;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,162 @@
+#include "service-list.h"
+
+#include "ns3/core-module.h"
+
+#include <cstring>
+
+#include "service-path.h"
+#include "service-codec.h"
+#include "service-catalog.h"
+
+NS_LOG_COMPONENT_DEFINE("ServiceList");
+
+ServiceList::ServiceList() {
+	Clear();
+}
+
+bool ServiceList::Add(int serviceId, const char *service, uint16_t serviceLength) {
+	if(nServices == MAX_OFFERED_SERVICES || (serviceId == UNKNOWN_SERVICE && namesSize + serviceLength > MAX_SERVICE_NAMES_SIZE)) {
+		return false;
+	}
+	serviceIds[nServices] = serviceId;
+	nameOffsets[nServices] = namesSize;
+	nameLengths[nServices] = 0;
+	if(serviceId == UNKNOWN_SERVICE) {
+		memmove(names + namesSize, service, serviceLength);
+		nameLengths[nServices] = serviceLength;
+		namesSize += serviceLength;
+	}
+	nServices++;
+	return true;
+}
+
+void ServiceList::Clear() {
+	nServices = 0;
+	namesSize = 0;
+}
+
+int ServiceList::GetSize() const {
+	return nServices;
+}
+
+std::list<std::string> ServiceList::GetServices() const {
+	std::list<std::string> services;
+	for(int i = 0; i < nServices; i++) {
+		services.push_back(ServiceCodec::GetService(serviceIds[i], std::string(names + nameOffsets[i], nameLengths[i])));
+	}
+	return services;
+}
+
+std::vector<int> ServiceList::GetServiceIds() const {
+	return std::vector<int>(serviceIds, serviceIds + nServices);
+}
+
+/*
+ * Catalog services take the path packed with the catalog, only names sent as strings are packed here.
+ * Same contract as ServicePath::Pack, paths are cleared if any service can not be packed.
+ */
+bool ServiceList::GetServicePaths(std::vector<SERVICE_PATH> &paths) const {
+	paths.resize(nServices);
+	for(int i = 0; i < nServices; i++) {
+		bool packed;
+		if(serviceIds[i] == UNKNOWN_SERVICE) {
+			packed = ServicePath::Pack(std::string(names + nameOffsets[i], nameLengths[i]), paths[i]);
+		} else {
+			packed = ServiceCatalog::GetServicePath(serviceIds[i], paths[i]);
+		}
+		if(!packed) {
+			paths.clear();
+			return false;
+		}
+	}
+	return true;
+}
+
+/*
+ * Compares without building any name, catalog services against the names the catalog keeps.
+ */
+bool ServiceList::Equals(const std::list<std::string> &services) const {
+	int i = 0;
+	for(std::list<std::string>::const_iterator service = services.begin(); service != services.end(); service++, i++) {
+		if(i == nServices) {
+			return false;
+		}
+		if(serviceIds[i] != UNKNOWN_SERVICE) {
+			if(*service != ServiceCatalog::GetService(serviceIds[i])) {
+				return false;
+			}
+		} else if(service->length() != nameLengths[i] || service->compare(0, nameLengths[i], names + nameOffsets[i], nameLengths[i]) != 0) {
+			return false;
+		}
+	}
+	return i == nServices;
+}
+
+void ServiceList::SetServices(std::list<std::string> services) {
+	Clear();
+	for(std::list<std::string>::iterator i = services.begin(); i != services.end(); i++) {
+		if(!Add(ServiceCodec::GetServiceId(*i), i->data(), i->length())) {
+			NS_LOG_WARN("Service " << *i << " does not fit in a list of " << MAX_OFFERED_SERVICES << " services and " << MAX_SERVICE_NAMES_SIZE << " bytes of names, dropped");
+		}
+	}
+}
+
+uint32_t ServiceList::GetSerializedSize() const {
+	uint32_t size = 2;
+	for(int i = 0; i < nServices; i++) {
+		size += ServiceCodec::GetSerializedSize(serviceIds[i], nameLengths[i]);
+	}
+	return size;
+}
+
+/*
+ * Size of the list at i, or 0 when the bytes left can not hold it. Every service takes at least two
+ * bytes, so a forged count runs out of them before it runs long.
+ */
+uint32_t ServiceList::PeekSerializedSize(Buffer::Iterator i) {
+	if(i.GetRemainingSize() < 2) {
+		return 0;
+	}
+	int nOfferedServices = i.ReadU16();
+	uint32_t size = 2;
+	for(int j = 0; j < nOfferedServices; j++) {
+		uint32_t serviceSize = ServiceCodec::PeekSerializedSize(i);
+		if(serviceSize == 0) {
+			return 0;
+		}
+		i.Next(serviceSize);
+		size += serviceSize;
+	}
+	return size;
+}
+
+void ServiceList::Serialize(Buffer::Iterator &serializer) const {
+	serializer.WriteU16(nServices);
+	for(int i = 0; i < nServices; i++) {
+		ServiceCodec::Serialize(serializer, serviceIds[i], names + nameOffsets[i], nameLengths[i]);
+	}
+}
+
+void ServiceList::Deserialize(Buffer::Iterator &i) {
+	Clear();
+	int nOfferedServices = i.ReadU16();
+	for(int j = 0; j < nOfferedServices; j++) {
+		uint16_t serviceLength;
+		uint16_t capacity = MAX_SERVICE_NAMES_SIZE - namesSize;
+		int serviceId = ServiceCodec::Deserialize(i, names + namesSize, serviceLength, capacity);
+		if(serviceLength > capacity || !Add(serviceId, names + namesSize, serviceLength)) {
+			NS_LOG_WARN("Received service " << j << " of " << nOfferedServices << " does not fit in the list, dropped");
+		}
+	}
+}
+
+void ServiceList::Print(std::ostream &stream) const {
+	for(int i = 0; i < nServices; i++) {
+		if(serviceIds[i] == UNKNOWN_SERVICE) {
+			stream.write(names + nameOffsets[i], nameLengths[i]);
+		} else {
+			stream << ServiceCatalog::GetService(serviceIds[i]);
+		}
+		stream << ", ";
+	}
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+#ifndef SERVICE_LIST_H
+#define SERVICE_LIST_H
+
+#include "ns3/header.h"
+
+#include <list>
+#include <vector>
+#include <string>
+#include <ostream>
+
+#include "definitions.h"
+
+using namespace ns3;
+
+/*
+ * Offered services of a notification kept inline, so decoding one allocates nothing: up to
+ * MAX_OFFERED_SERVICES catalog ids, with the names of services outside the catalog packed in a
+ * fixed arena. Services beyond that capacity are dropped with a warning. The central compares the
+ * list against the services it already knows in place, and only builds names when they changed.
+ */
+class ServiceList {
+
+	public:
+		ServiceList();
+
+	private:
+		int nServices;
+		int namesSize;
+		int serviceIds[MAX_OFFERED_SERVICES];
+		uint16_t nameOffsets[MAX_OFFERED_SERVICES];
+		uint16_t nameLengths[MAX_OFFERED_SERVICES];
+		char names[MAX_SERVICE_NAMES_SIZE];
+
+		bool Add(int serviceId, const char *service, uint16_t serviceLength);
+
+	public:
+		void Clear();
+		int GetSize() const;
+		std::list<std::string> GetServices() const;
+		std::vector<int> GetServiceIds() const;
+		bool GetServicePaths(std::vector<SERVICE_PATH> &paths) const;
+		bool Equals(const std::list<std::string> &services) const;
+		void SetServices(std::list<std::string> services);
+
+		uint32_t GetSerializedSize() const;
+		static uint32_t PeekSerializedSize(Buffer::Iterator i);
+		void Serialize(Buffer::Iterator &serializer) const;
+		void Deserialize(Buffer::Iterator &i);
+		void Print(std::ostream &stream) const;
+};
+
+#endif
\ No newline at end of file
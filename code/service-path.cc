@@ -0,0 +1,68 @@
+#include "service-path.h"
+
+#include "ns3/core-module.h"
+
+NS_LOG_COMPONENT_DEFINE("ServicePath");
+
+bool ServicePath::Pack(std::string service, SERVICE_PATH &path) {
+	NS_LOG_FUNCTION(service);
+	if(service.length() > MAX_SERVICE_PATH_DEPTH) {
+		NS_LOG_DEBUG("Service " << service << " is too deep to be packed");
+		return false;
+	}
+	path.digits = 0;
+	path.depth = service.length();
+	for(int i = 0; i < path.depth; i++) {
+		if(service[i] < '0' || service[i] > '9') {
+			NS_LOG_DEBUG("Service " << service << " is not a path of digits");
+			return false;
+		}
+		path.digits |= (uint64_t) (service[i] - '0') << (60 - 4 * i);
+	}
+	return true;
+}
+
+bool ServicePath::Pack(std::list<std::string> services, std::vector<SERVICE_PATH> &paths) {
+	NS_LOG_FUNCTION(&services);
+	paths.resize(services.size());
+	std::vector<SERVICE_PATH>::iterator path = paths.begin();
+	for(std::list<std::string>::iterator i = services.begin(); i != services.end(); i++, path++) {
+		if(!Pack(*i, *path)) {
+			paths.clear();
+			return false;
+		}
+	}
+	return true;
+}
+
+/*
+ * Same rule as ServiceCatalog::CalculateSemanticDistance: zero when the offered service is the
+ * common prefix, the longest way from either service up to the common prefix otherwise. The last
+ * nibble of a packed path is always zero, so the XOR can be ORed with 1 to keep the count defined.
+ */
+int ServicePath::SemanticDistance(SERVICE_PATH requiredService, SERVICE_PATH offeredService) {
+	int commonPrefix = __builtin_clzll((requiredService.digits ^ offeredService.digits) | 1) >> 2;
+	int minDepth = requiredService.depth < offeredService.depth ? requiredService.depth : offeredService.depth;
+	int maxDepth = requiredService.depth < offeredService.depth ? offeredService.depth : requiredService.depth;
+	commonPrefix = commonPrefix < minDepth ? commonPrefix : minDepth;
+	return (maxDepth - commonPrefix) & -(commonPrefix != offeredService.depth);
+}
+
+/*
+ * Batch form for scoring one request against the offered services of many nodes. The loop has no
+ * branches or calls, so it is unrolled and pipelined, and vectorized on targets with a vector
+ * leading zero count.
+ */
+void ServicePath::SemanticDistances(SERVICE_PATH requiredService, const SERVICE_PATH *offeredServices, int nOfferedServices, int *semanticDistances) {
+	NS_LOG_FUNCTION(nOfferedServices);
+	uint64_t digits = requiredService.digits;
+	int depth = requiredService.depth;
+	for(int i = 0; i < nOfferedServices; i++) {
+		int commonPrefix = __builtin_clzll((digits ^ offeredServices[i].digits) | 1) >> 2;
+		int offeredDepth = offeredServices[i].depth;
+		int minDepth = depth < offeredDepth ? depth : offeredDepth;
+		int maxDepth = depth < offeredDepth ? offeredDepth : depth;
+		commonPrefix = commonPrefix < minDepth ? commonPrefix : minDepth;
+		semanticDistances[i] = (maxDepth - commonPrefix) & -(commonPrefix != offeredDepth);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,26 @@
+#ifndef SERVICE_PATH_H
+#define SERVICE_PATH_H
+
+#include <list>
+#include <string>
+#include <vector>
+
+#include "definitions.h"
+
+/*
+ * Services are paths in the ontology tree, one digit per level. Packed into an integer with
+ * the first digit in the top nibble, the common prefix of two services is the number of leading
+ * zero nibbles of their XOR, so the semantic distance needs no string comparison at all.
+ * Services with other characters or deeper than MAX_SERVICE_PATH_DEPTH can not be packed.
+ */
+class ServicePath {
+
+	public:
+		static bool Pack(std::string service, SERVICE_PATH &path);
+		static bool Pack(std::list<std::string> services, std::vector<SERVICE_PATH> &paths);
+
+		static int SemanticDistance(SERVICE_PATH requiredService, SERVICE_PATH offeredService);
+		static void SemanticDistances(SERVICE_PATH requiredService, const SERVICE_PATH *offeredServices, int nOfferedServices, int *semanticDistances);
+};
+
+#endif
\ No newline at end of file
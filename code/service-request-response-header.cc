@@ -3,6 +3,7 @@
 #include "ns3/address-utils.h"
 
 #include "utilities.h"
+#include "service-codec.h"
 
 TypeId ServiceRequestResponseHeader::GetTypeId() {
 	static TypeId typeId = TypeId("ServiceRequestResponseHeader")
@@ -16,7 +17,7 @@ TypeId ServiceRequestResponseHeader::GetInstanceTypeId() const {
 }
 
 uint32_t ServiceRequestResponseHeader::GetSerializedSize() const {
-	return 11 + serviceSize;
+	return 19 + ServiceCodec::GetSerializedSize(serviceId, service);
 }
 
 void ServiceRequestResponseHeader::Print(std::ostream &stream) const {
@@ -47,39 +48,39 @@ void ServiceRequestResponseHeader::Print(std::ostream &stream) const {
 			type = "unknown";
 			flag = "unknown";
 	}
-	stream << "Service " << type << " sent from " << senderAddress << " to " << destinationAddress << " for service " << service << " with flag " << flag;
+	stream << "Service " << type << " sent from " << senderAddress << " to " << destinationAddress << " for service " << ServiceCodec::GetService(serviceId, service) << " with flag " << flag << " (sequence " << sequence << ", acknowledgement " << acknowledgement << ", window " << window << ")";
 }
 
 uint32_t ServiceRequestResponseHeader::Deserialize(Buffer::Iterator start) {
 	Buffer::Iterator i = start;
 	flag = (Flag) i.ReadU8();
+	window = i.ReadU16();
+	sequence = i.ReadU32();
+	acknowledgement = i.ReadU32();
 	ReadFrom(i, senderAddress);
 	ReadFrom(i, destinationAddress);
-	serviceSize = i.ReadU16();
-	char tmp[serviceSize + 1];
-	for(int j = 0; j < serviceSize; j++) {
-		tmp[j] = i.ReadU8();
-	}
-	tmp[serviceSize] = '\0';
-	service = std::string(tmp);
+	serviceId = ServiceCodec::Deserialize(i, service);
 	uint32_t size = i.GetDistanceFrom(start);
 	return size;
 }
 
 void ServiceRequestResponseHeader::Serialize(Buffer::Iterator serializer) const {
 	serializer.WriteU8(flag);
+	serializer.WriteU16(window);
+	serializer.WriteU32(sequence);
+	serializer.WriteU32(acknowledgement);
 	WriteTo(serializer, senderAddress);
 	WriteTo(serializer, destinationAddress);
-	serializer.WriteU16(serviceSize);
-	for(int i = 0; i < serviceSize; i++) {
-		serializer.WriteU8(service.at(i));
-	}
+	ServiceCodec::Serialize(serializer, serviceId, service);
 }
 
 ServiceRequestResponseHeader::ServiceRequestResponseHeader() {
 	flag = STRATOS_NULL;
+	window = 1;
+	sequence = 0;
+	acknowledgement = 0;
 	service = "0";
-	serviceSize = 1;
+	serviceId = UNKNOWN_SERVICE;
 	senderAddress = Ipv4Address::GetAny();
 	destinationAddress = Ipv4Address::GetAny();
 }
@@ -88,8 +89,24 @@ Flag ServiceRequestResponseHeader::GetFlag() {
 	return flag;
 }
 
+int ServiceRequestResponseHeader::GetWindow() {
+	return window;
+}
+
+int ServiceRequestResponseHeader::GetSequence() {
+	return sequence;
+}
+
+int ServiceRequestResponseHeader::GetAcknowledgement() {
+	return acknowledgement;
+}
+
 std::string ServiceRequestResponseHeader::GetService() {
-	return service;
+	return ServiceCodec::GetService(serviceId, service);
+}
+
+int ServiceRequestResponseHeader::GetServiceId() {
+	return serviceId;
 }
 
 Ipv4Address ServiceRequestResponseHeader::GetSenderAddress() {
@@ -104,9 +121,21 @@ void ServiceRequestResponseHeader::SetFlag(Flag flag) {
 	this->flag = flag;
 }
 
+void ServiceRequestResponseHeader::SetWindow(int window) {
+	this->window = window;
+}
+
+void ServiceRequestResponseHeader::SetSequence(int sequence) {
+	this->sequence = sequence;
+}
+
+void ServiceRequestResponseHeader::SetAcknowledgement(int acknowledgement) {
+	this->acknowledgement = acknowledgement;
+}
+
 void ServiceRequestResponseHeader::SetService(std::string service) {
-	this->service = service;
-	serviceSize = service.length();
+	serviceId = ServiceCodec::GetServiceId(service);
+	this->service = serviceId == UNKNOWN_SERVICE ? service : std::string();
 }
 
 void ServiceRequestResponseHeader::SetSenderAddress(Ipv4Address senderAddress) {
@@ -19,9 +19,12 @@ class ServiceRequestResponseHeader : public Header {
 		virtual void Serialize(Buffer::Iterator serializer) const;
 
 	private:
-		int serviceSize;
+		int serviceId;
 
 		Flag flag;
+		int window;
+		int sequence;
+		int acknowledgement;
 		std::string service;
 		Ipv4Address senderAddress;
 		Ipv4Address destinationAddress;
@@ -30,11 +33,18 @@ class ServiceRequestResponseHeader : public Header {
 		ServiceRequestResponseHeader();
 
 		Flag GetFlag();
+		int GetWindow();
+		int GetSequence();
+		int GetAcknowledgement();
 		std::string GetService();
+		int GetServiceId();
 		Ipv4Address GetSenderAddress();
 		Ipv4Address GetDestinationAddress();
 
 		void SetFlag(Flag flag);
+		void SetWindow(int window);
+		void SetSequence(int sequence);
+		void SetAcknowledgement(int acknowledgement);
 		void SetService(std::string service);
 		void SetSenderAddress(Ipv4Address senderAddress);
 		void SetDestinationAddress(Ipv4Address destinationAddress);
@@ -0,0 +1,107 @@
+#include "session-table.h"
+
+NS_LOG_COMPONENT_DEFINE("SessionTable");
+
+SessionTable::SessionTable() {
+	NS_LOG_FUNCTION(this);
+	size = 0;
+	used.resize(INITIAL_SESSION_SLOTS, false);
+	slots.resize(INITIAL_SESSION_SLOTS);
+}
+
+int SessionTable::GetHomeSlot(SESSION_KEY key) const {
+	uint hash = key.first * 2654435761u ^ ((uint) key.second + 0x9E3779B9u) * 0x85EBCA6Bu;
+	hash ^= hash >> 16;
+	return hash & (slots.size() - 1);
+}
+
+int SessionTable::FindSlot(SESSION_KEY key) const {
+	int mask = slots.size() - 1;
+	for(int i = GetHomeSlot(key); used[i]; i = (i + 1) & mask) {
+		if(slots[i].key == key) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+void SessionTable::Grow() {
+	NS_LOG_FUNCTION(this << slots.size());
+	std::vector<bool> oldUsed;
+	std::vector<SERVICE_SESSION> oldSlots;
+	oldUsed.swap(used);
+	oldSlots.swap(slots);
+	used.resize(oldSlots.size() * 2, false);
+	slots.resize(oldSlots.size() * 2);
+	int mask = slots.size() - 1;
+	for(uint i = 0; i < oldSlots.size(); i++) {
+		if(oldUsed[i]) {
+			int j = GetHomeSlot(oldSlots[i].key);
+			while(used[j]) {
+				j = (j + 1) & mask;
+			}
+			used[j] = true;
+			slots[j] = oldSlots[i];
+		}
+	}
+}
+
+int SessionTable::GetSize() const {
+	return size;
+}
+
+int SessionTable::GetCapacity() const {
+	return slots.size();
+}
+
+SERVICE_SESSION * SessionTable::Find(SESSION_KEY key) {
+	int slot = FindSlot(key);
+	return slot < 0 ? NULL : &slots[slot];
+}
+
+/*
+ * Returns the session of the key, creating an idle one if there is none. Creating a session
+ * may move the others, so pointers and references to them are only valid until then.
+ */
+SERVICE_SESSION & SessionTable::Get(SESSION_KEY key) {
+	int slot = FindSlot(key);
+	if(slot >= 0) {
+		return slots[slot];
+	}
+	//Kept at most 3/4 full so probe runs stay short
+	if((size + 1) * 4 > (int) slots.size() * 3) {
+		Grow();
+	}
+	int mask = slots.size() - 1;
+	slot = GetHomeSlot(key);
+	while(used[slot]) {
+		slot = (slot + 1) & mask;
+	}
+	SERVICE_SESSION session = SERVICE_SESSION();
+	session.key = key;
+	session.status = STRATOS_NULL;
+	used[slot] = true;
+	slots[slot] = session;
+	size++;
+	return slots[slot];
+}
+
+bool SessionTable::Erase(SESSION_KEY key) {
+	int hole = FindSlot(key);
+	if(hole < 0) {
+		return false;
+	}
+	int mask = slots.size() - 1;
+	for(int i = (hole + 1) & mask; used[i]; i = (i + 1) & mask) {
+		//Sessions whose home slot is not between the hole and them would become unreachable
+		int home = GetHomeSlot(slots[i].key);
+		if(((i - home) & mask) >= ((i - hole) & mask)) {
+			slots[hole] = slots[i];
+			hole = i;
+		}
+	}
+	used[hole] = false;
+	slots[hole] = SERVICE_SESSION();
+	size--;
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+#ifndef SESSION_TABLE_H
+#define SESSION_TABLE_H
+
+#include "ns3/core-module.h"
+
+#include <set>
+#include <vector>
+
+#include "definitions.h"
+
+using namespace ns3;
+
+typedef std::pair<uint, int> SESSION_KEY;
+
+struct SERVICE_SESSION {
+	SESSION_KEY key;
+	Flag status;
+	int packets;
+	int maxPackets;
+	int window;
+	int acknowledgements;
+	bool inFlight;
+	TRANSMISSION transmission;
+	std::set<int> outOfOrderPackets;
+	EventId timer;
+	EventId resend;
+};
+
+/*
+ * Service sessions of a node keyed by peer address and service id, in a single open addressing
+ * table with linear probing. Erasing shifts back the rest of the probe run instead of leaving
+ * tombstones, so lookups stay short however many sessions have come and gone.
+ */
+class SessionTable {
+
+	public:
+		SessionTable();
+
+	private:
+		int size;
+		std::vector<bool> used;
+		std::vector<SERVICE_SESSION> slots;
+
+		int GetHomeSlot(SESSION_KEY key) const;
+		int FindSlot(SESSION_KEY key) const;
+		void Grow();
+
+	public:
+		int GetSize() const;
+		int GetCapacity() const;
+		SERVICE_SESSION * Find(SESSION_KEY key);
+		SERVICE_SESSION & Get(SESSION_KEY key);
+		bool Erase(SESSION_KEY key);
+};
+
+#endif
\ No newline at end of file
@@ -7,8 +7,17 @@
 #include "ns3/applications-module.h"
 #include "ns3/flow-monitor-helper.h"
 
+#include <cmath>
+#include <algorithm>
+
 #include "utilities.h"
+#include "benchmark.h"
 #include "definitions.h"
+#include "central-server.h"
+#include "load-generator.h"
+#include "sweep-runner.h"
+#include "wire-format.h"
+#include "service-catalog.h"
 #include "search-application.h"
 #include "central-application.h"
 #include "service-application.h"
@@ -22,73 +31,319 @@ NS_LOG_COMPONENT_DEFINE("Stratos");
 Stratos::Stratos(int argc, char *argv[]) {
 	NS_LOG_FUNCTION(this);
 	MAX_SCHEDULE_SIZE = 3; // 1, 2, 3*, 4, 5
+	NUMBER_OF_NODES = TOTAL_NUMBER_OF_NODES; //100*, 1000, 5000, 10000
 	NUMBER_OF_MOBILE_NODES = 50; //0, 25, 50*, 100
 	NUMBER_OF_REQUESTER_NODES = 4; //1, 2, 4*, 8, 16, 24, 32
 	NUMBER_OF_PACKETS_TO_SEND = 20; //10, 20*, 40, 60
 	NUMBER_OF_SERVICES_OFFERED = 2; //1, 2*, 4, 8
+	SERVICE_WINDOW_SIZE = 1; //1*, 4, 8, 16
+	PARALLEL_SCHEDULE = false;
+	ADAPTIVE_TIMERS = false;
+	DELTA_NOTIFICATIONS = false;
+	NOTIFICATION_DISTANCE_THRESHOLD = NOTIFICATION_DISTANCE;
+	KEEPALIVE_INTERVAL = KEEPALIVE_TIME;
+	VELOCITY_NOTIFICATIONS = false;
+	PREDICTION_MARGIN = 0;
+	EXPIRY = 0;
+	MAX_SPEED = MAX_NODE_SPEED;
+	ORIGIN_X = 0;
+	ORIGIN_Y = 0;
+	AREA_SIZE = 0;
+	SEED = 0;
+	RUN = 1;
+	PROFILE = false;
+	USE_SPATIAL_INDEX = true;
+	USE_TOP_K_SELECTION = true;
+	USE_SERVICE_INDEX = false;
+	SERVER = false;
+	SERVER_PORT = SEARCH_PORT;
+	NUMBER_OF_SERVER_THREADS = SERVER_THREADS;
+	BENCHMARK_SIZES = "10,100,1000,10000";
+	LOAD = false;
+	LOAD_NODES = "1000,10000";
+	LOAD_SCHEDULES = "1,3,5";
+	NUMBER_OF_LOAD_REQUESTS = 1000;
+	LOAD_NOTIFICATIONS = 1;
+	SWEEP = false;
+	SWEEP_DIRECTORY = "stratos";
+	NUMBER_OF_SWEEP_RUNS = 100;
+	NUMBER_OF_SWEEP_WORKERS = 0;
 
 	NS_LOG_INFO("Parsing argument values if any");
 	CommandLine cmd;
 	cmd.AddValue("nSchedule", "Max number of nodes in a schedule.", MAX_SCHEDULE_SIZE);
+	cmd.AddValue("nNodes", "Total number of nodes, including the central.", NUMBER_OF_NODES);
 	cmd.AddValue("nMobile", "Number of mobile nodes.", NUMBER_OF_MOBILE_NODES);
 	cmd.AddValue("nRequesters", "Number of requester nodes.", NUMBER_OF_REQUESTER_NODES);
 	cmd.AddValue("nPackets", "Number of service packets to send.", NUMBER_OF_PACKETS_TO_SEND);
 	cmd.AddValue("nServices", "Number of services offered by a node.", NUMBER_OF_SERVICES_OFFERED);
+	cmd.AddValue("parallelSchedule", "Contact all the nodes in a schedule at once.", PARALLEL_SCHEDULE);
+	cmd.AddValue("adaptiveTimers", "Derive retransmission timeouts from the measured RTT to each peer.", ADAPTIVE_TIMERS);
+	cmd.AddValue("deltaNotifications", "Notify the central only the fields that changed since the last notification.", DELTA_NOTIFICATIONS);
+	cmd.AddValue("notificationDistance", "Meters a node has to move before notifying its position.", NOTIFICATION_DISTANCE_THRESHOLD);
+	cmd.AddValue("keepaliveTime", "Seconds between full notifications when nothing changed.", KEEPALIVE_INTERVAL);
+	cmd.AddValue("velocityNotifications", "Notify velocities so the central predicts positions at request time, needs deltaNotifications.", VELOCITY_NOTIFICATIONS);
+	cmd.AddValue("predictionMargin", "Meters added to the request radius in the central, negative to narrow it.", PREDICTION_MARGIN);
+	cmd.AddValue("expiry", "Hello periods a node may go unheard before the central evicts it, 0 to never evict.", EXPIRY);
+	cmd.AddValue("maxSpeed", "Highest speed in m/s the central believes a node reports, faster velocities are clamped to it.", MAX_SPEED);
+	cmd.AddValue("originX", "X of the origin positions are encoded relative to on the wire.", ORIGIN_X);
+	cmd.AddValue("originY", "Y of the origin positions are encoded relative to on the wire.", ORIGIN_Y);
+	cmd.AddValue("area", "Side in meters of the square the nodes are placed in, 0 to keep the density of the default fleet.", AREA_SIZE);
+	cmd.AddValue("seed", "Seed of the random number generator, 0 for the current time.", SEED);
+	cmd.AddValue("run", "Run of the random number generator, the first one of the runs of a sweep.", RUN);
+	cmd.AddValue("profile", "Report wall-clock time and peak resident memory of each simulation phase to stderr.", PROFILE);
+	cmd.AddValue("window", "Max number of service packets in flight, 1 for stop-and-wait.", SERVICE_WINDOW_SIZE);
+	cmd.AddValue("spatialIndex", "Use a grid index in the central to find nodes in the area of interest.", USE_SPATIAL_INDEX);
+	cmd.AddValue("topKSelection", "Select the schedule in the central with a single pass bounded heap.", USE_TOP_K_SELECTION);
+	cmd.AddValue("serviceIndex", "Walk posting lists of the requested service in the central, stopping once the schedule can not improve.", USE_SERVICE_INDEX);
+	cmd.AddValue("catalog", "File with a custom service catalog, one ontology path per line.", CATALOG);
+	cmd.AddValue("benchmark", "Run the named benchmark instead of the simulation (spatialIndex, scheduleSelection, notificationMemory, wireFormat, randomDraw, sessionTable, servicePaths, nodeTable, radiusFilter, expiry, serviceIndex, kernels).", BENCHMARK);
+	cmd.AddValue("benchmarkSizes", "Comma separated input sizes of the kernels benchmark, which prints CSV.", BENCHMARK_SIZES);
+	cmd.AddValue("server", "Serve the central protocol over real UDP sockets instead of running the simulation.", SERVER);
+	cmd.AddValue("serverPort", "UDP port of the central server.", SERVER_PORT);
+	cmd.AddValue("serverThreads", "Number of worker threads of the central server.", NUMBER_OF_SERVER_THREADS);
+	cmd.AddValue("load", "Run the closed-loop load generator against the central matcher instead of the simulation.", LOAD);
+	cmd.AddValue("loadNodes", "Comma separated registry sizes of the load generator.", LOAD_NODES);
+	cmd.AddValue("loadSchedules", "Comma separated schedule sizes of the in-process load generator.", LOAD_SCHEDULES);
+	cmd.AddValue("loadRequests", "Number of requests sent by the load generator for each configuration.", NUMBER_OF_LOAD_REQUESTS);
+	cmd.AddValue("loadNotifications", "Notifications sent by the load generator before each request.", LOAD_NOTIFICATIONS);
+	cmd.AddValue("loadServer", "Address of a central server to load over UDP, in-process if empty.", LOAD_SERVER);
+	cmd.AddValue("sweep", "Run a parameter sweep of the simulation on a pool of worker processes.", SWEEP);
+	cmd.AddValue("sweepSchedule", "Comma separated max schedule sizes of the sweep.", SWEEP_SCHEDULE);
+	cmd.AddValue("sweepMobile", "Comma separated numbers of mobile nodes of the sweep.", SWEEP_MOBILE);
+	cmd.AddValue("sweepRequesters", "Comma separated numbers of requester nodes of the sweep.", SWEEP_REQUESTERS);
+	cmd.AddValue("sweepPackets", "Comma separated numbers of service packets of the sweep.", SWEEP_PACKETS);
+	cmd.AddValue("sweepServices", "Comma separated numbers of services offered by a node of the sweep.", SWEEP_SERVICES);
+	cmd.AddValue("sweepName", "Name of the result files of the sweep instead of the swept parameter.", SWEEP_NAME);
+	cmd.AddValue("sweepDirectory", "Directory the result files of the sweep are appended to.", SWEEP_DIRECTORY);
+	cmd.AddValue("sweepRuns", "Number of simulations of each configuration of the sweep.", NUMBER_OF_SWEEP_RUNS);
+	cmd.AddValue("sweepWorkers", "Number of simulations run at once by the sweep, 0 for one per core.", NUMBER_OF_SWEEP_WORKERS);
 	cmd.Parse(argc, argv);
+	CheckParameters();
+	if(AREA_SIZE == 0) {
+		//Same density as the default fleet in the default area
+		AREA_SIZE = MAX_DISTANCE * sqrt((double) NUMBER_OF_NODES / TOTAL_NUMBER_OF_NODES);
+	}
+	NS_LOG_INFO("Number of nodes = " << NUMBER_OF_NODES);
+	NS_LOG_INFO("Area size = " << AREA_SIZE);
 	NS_LOG_INFO("Max schedule size = " << MAX_SCHEDULE_SIZE);
 	NS_LOG_INFO("Number of mobile nodes = " << NUMBER_OF_MOBILE_NODES);
 	NS_LOG_INFO("Number of requester nodes = " << NUMBER_OF_REQUESTER_NODES);
 	NS_LOG_INFO("Number of service packets to send = " << NUMBER_OF_PACKETS_TO_SEND);
 	NS_LOG_INFO("Number of services offered by a node = " << NUMBER_OF_SERVICES_OFFERED);
+	NS_LOG_INFO("Service window size = " << SERVICE_WINDOW_SIZE);
+	NS_LOG_INFO("Parallel schedule = " << PARALLEL_SCHEDULE);
+	NS_LOG_INFO("Adaptive retransmission timers = " << ADAPTIVE_TIMERS);
+	NS_LOG_INFO("Delta notifications = " << DELTA_NOTIFICATIONS);
+	NS_LOG_INFO("Notification distance threshold = " << NOTIFICATION_DISTANCE_THRESHOLD);
+	NS_LOG_INFO("Keepalive interval = " << KEEPALIVE_INTERVAL);
+	NS_LOG_INFO("Velocity notifications = " << VELOCITY_NOTIFICATIONS);
+	NS_LOG_INFO("Prediction margin = " << PREDICTION_MARGIN);
+	NS_LOG_INFO("Expiry = " << EXPIRY);
+	NS_LOG_INFO("Max speed = " << MAX_SPEED);
+	NS_LOG_INFO("Use spatial index = " << USE_SPATIAL_INDEX);
+	NS_LOG_INFO("Use top-k schedule selection = " << USE_TOP_K_SELECTION);
+	NS_LOG_INFO("Use service index = " << USE_SERVICE_INDEX);
+
+	POSITION origin;
+	origin.x = ORIGIN_X;
+	origin.y = ORIGIN_Y;
+	WireFormat::SetOrigin(origin);
+	NS_LOG_INFO("Wire format origin = (" << ORIGIN_X << ", " << ORIGIN_Y << ")");
 
-	SeedManager::SetSeed(time(NULL));
-	NS_LOG_INFO("Random seed seted to current time");
+	if(!CATALOG.empty()) {
+		ServiceCatalog::LoadFromFile(CATALOG);
+		NS_LOG_INFO("Service catalog loaded from " << CATALOG);
+	}
+
+	if(SEED == 0) {
+		SEED = time(NULL);
+	}
+	SeedManager::SetSeed(SEED);
+	SeedManager::SetRun(RUN);
+	NS_LOG_INFO("Random seed = " << SEED << ", run = " << RUN);
+	//Streams below these are the cached ones of Utilities
+	nextStream = NUMBER_OF_RANDOM_STREAMS;
 }
 
 void Stratos::Run() {
 	NS_LOG_FUNCTION(this);
+	double start = Utilities::GetWallClockTime();
 	std::map<int, int> nodos;
 	for(; nodos.size() < (uint) NUMBER_OF_REQUESTER_NODES;) {
-		int nodo = Utilities::Random(1, TOTAL_NUMBER_OF_NODES - 1);
+		int nodo = Utilities::Random(1, NUMBER_OF_NODES - 1);
 		nodos[nodo] = nodo;
 	}
 	Ptr<SearchApplication> searchApp;
-	Ptr<ResultsApplication> resultsApp;
 	Ptr<ResultsApplication> requesterResultsApp;
+	std::vector<Ptr<ResultsApplication> > resultsApps;
+	for(int j = 1; j < NUMBER_OF_NODES; j++) {
+		resultsApps.push_back(DynamicCast<ResultsApplication>(wifiNodes.Get(j)->GetApplication(4)));
+	}
 	for(std::map<int, int>::iterator i = nodos.begin(); i != nodos.end(); i++) {
 		double requestTime = Utilities::Random(2, MAX_REQUEST_TIME);
 		searchApp = DynamicCast<SearchApplication>(wifiNodes.Get(i->first)->GetApplication(2));
 		requesterResultsApp = DynamicCast<ResultsApplication>(wifiNodes.Get(i->first)->GetApplication(4));
 		Simulator::Schedule(Seconds(requestTime), &SearchApplication::CreateAndSendRequest, searchApp);
-		for(int j = 1; j < TOTAL_NUMBER_OF_NODES; j++) {
-			resultsApp = DynamicCast<ResultsApplication>(wifiNodes.Get(j)->GetApplication(4));
-			Simulator::Schedule(Seconds(requestTime), &ResultsApplication::EvaluateNode, resultsApp, requesterResultsApp);
-		}
+		//Scheduled after the request at the same time, so it sees the request position, service and distance
+		Simulator::Schedule(Seconds(requestTime), &ResultsApplication::EvaluateNodes, requesterResultsApp, resultsApps);
 	}
 	Ptr<FlowMonitor> flowMonitor;
 	FlowMonitorHelper flowHelper;
 	flowMonitor = flowHelper.InstallAll();
 	Simulator::Stop(Seconds(TOTAL_SIMULATION_TIME));
 	Simulator::Run();
+	ReportPhase("Run", start);
 	double bytes = 0;
 	std::map<FlowId, FlowMonitor::FlowStats> stats = flowMonitor->GetFlowStats();
 	for(std::map<FlowId, FlowMonitor::FlowStats>::iterator i = stats.begin(); i != stats.end(); i++) {
 		bytes += i->second.txBytes;
 	}
+	double savedBytes = 0;
+	for(int i = 1; i < NUMBER_OF_NODES; i++) {
+		searchApp = DynamicCast<SearchApplication>(wifiNodes.Get(i)->GetApplication(2));
+		if(searchApp != NULL) {
+			savedBytes += searchApp->GetNotificationBytesSaved();
+		}
+	}
+	NS_LOG_INFO("Total bytes sent = " << bytes << ", notification bytes saved = " << savedBytes);
+	Ptr<CentralApplication> centralApp = DynamicCast<CentralApplication>(wifiNodes.Get(0)->GetApplication(2));
+	NS_LOG_INFO("Stale nodes evicted by the central = " << centralApp->GetEvictions());
 	std::cout << bytes << std::endl;
 	Simulator::Destroy();
 }
 
+bool Stratos::IsSweep() {
+	NS_LOG_FUNCTION(this);
+	return SWEEP;
+}
+
+/*
+ * Every configuration changes a single parameter of the command line ones, like the serial
+ * runs of PerformTests did, and every simulation of the sweep gets its own RNG run.
+ */
+int Stratos::RunSweep() {
+	NS_LOG_FUNCTION(this);
+	std::map<std::string, std::vector<int> > grid;
+	grid["schedule"] = LoadGenerator::ParseList(SWEEP_SCHEDULE);
+	grid["mobile"] = LoadGenerator::ParseList(SWEEP_MOBILE);
+	grid["requesters"] = LoadGenerator::ParseList(SWEEP_REQUESTERS);
+	grid["packets"] = LoadGenerator::ParseList(SWEEP_PACKETS);
+	grid["services"] = LoadGenerator::ParseList(SWEEP_SERVICES);
+	SweepRunner runner(SWEEP_DIRECTORY, SWEEP_NAME, NUMBER_OF_SWEEP_WORKERS);
+	int run = 0;
+	for(int i = 0; i < NUMBER_OF_SWEEP_RUNS; i++) {
+		for(std::map<std::string, std::vector<int> >::iterator j = grid.begin(); j != grid.end(); j++) {
+			for(std::vector<int>::iterator k = j->second.begin(); k != j->second.end(); k++) {
+				SWEEP_JOB job;
+				job.parameter = j->first;
+				job.value = *k;
+				job.run = RUN + run++;
+				runner.AddJob(job);
+			}
+		}
+	}
+	SWEEP_JOB job;
+	if(!runner.Run(job)) {
+		return runner.GetFailedJobs() == 0 ? 0 : 1;
+	}
+	//From here on this is a forked worker running the simulation of its job
+	if(job.parameter == "schedule") {
+		MAX_SCHEDULE_SIZE = job.value;
+	} else if(job.parameter == "mobile") {
+		NUMBER_OF_MOBILE_NODES = job.value;
+	} else if(job.parameter == "requesters") {
+		NUMBER_OF_REQUESTER_NODES = job.value;
+	} else if(job.parameter == "packets") {
+		NUMBER_OF_PACKETS_TO_SEND = job.value;
+	} else if(job.parameter == "services") {
+		NUMBER_OF_SERVICES_OFFERED = job.value;
+	}
+	CheckParameters();
+	SeedManager::SetRun(job.run);
+	CreateNodes();
+	CreateDevices();
+	InstallInternetStack();
+	InstallApplications();
+	Run();
+	runner.Finish();
+	return 0;
+}
+
+bool Stratos::IsBenchmark() {
+	NS_LOG_FUNCTION(this);
+	return !BENCHMARK.empty();
+}
+
+int Stratos::RunBenchmark() {
+	NS_LOG_FUNCTION(this);
+	return Benchmark::Run(BENCHMARK, LoadGenerator::ParseList(BENCHMARK_SIZES)) ? 0 : 1;
+}
+
+bool Stratos::IsServer() {
+	NS_LOG_FUNCTION(this);
+	return SERVER;
+}
+
+void Stratos::RunServer() {
+	NS_LOG_FUNCTION(this);
+	CentralMatcher matcher;
+	matcher.SetScheduleSize(MAX_SCHEDULE_SIZE);
+	matcher.SetSpatialIndex(USE_SPATIAL_INDEX);
+	matcher.SetTopKSelection(USE_TOP_K_SELECTION);
+	matcher.SetServiceIndex(USE_SERVICE_INDEX);
+	matcher.SetMaxSpeed(MAX_SPEED);
+	//Request timestamps are on the client clocks, so only the registry expires nodes
+	matcher.SetExpiryTime(EXPIRY * HELLO_TIME * 1000, false);
+	CentralServer server(matcher, SERVER_PORT, NUMBER_OF_SERVER_THREADS);
+	server.Run();
+}
+
+bool Stratos::IsLoad() {
+	NS_LOG_FUNCTION(this);
+	return LOAD;
+}
+
+void Stratos::RunLoad() {
+	NS_LOG_FUNCTION(this);
+	std::vector<int> nodes = LoadGenerator::ParseList(LOAD_NODES);
+	std::vector<int> schedules = LoadGenerator::ParseList(LOAD_SCHEDULES);
+	//A server keeps the nodes of previous runs, so sizes must grow
+	std::sort(nodes.begin(), nodes.end());
+	for(std::vector<int>::iterator i = nodes.begin(); i != nodes.end(); i++) {
+		LoadGenerator generator(*i, NUMBER_OF_LOAD_REQUESTS, LOAD_NOTIFICATIONS);
+		if(!LOAD_SERVER.empty()) {
+			generator.Run(LOAD_SERVER, SERVER_PORT);
+			generator.Report(std::cout, "udp", "server");
+			continue;
+		}
+		for(std::vector<int>::iterator j = schedules.begin(); j != schedules.end(); j++) {
+			CentralMatcher matcher;
+			matcher.SetScheduleSize(*j);
+			matcher.SetSpatialIndex(USE_SPATIAL_INDEX);
+			matcher.SetTopKSelection(USE_TOP_K_SELECTION);
+			matcher.SetServiceIndex(USE_SERVICE_INDEX);
+			generator.Run(matcher);
+			std::ostringstream nSchedule;
+			nSchedule << *j;
+			generator.Report(std::cout, "inProcess", nSchedule.str());
+		}
+	}
+}
+
 void Stratos::CreateNodes() {
 	NS_LOG_FUNCTION(this);
+	double start = Utilities::GetWallClockTime();
 	CreateMobileNodes();
 	CreateStaticNodes();
 	wifiNodes.Add(mobileNodes);
 	wifiNodes.Add(staticNodes);
+	ReportPhase("CreateNodes", start);
 }
 
 void Stratos::CreateDevices() {
 	NS_LOG_FUNCTION(this);
+	double start = Utilities::GetWallClockTime();
 	YansWifiChannelHelper wifiChannel = YansWifiChannelHelper::Default();
 	YansWifiPhyHelper wifiPhy = YansWifiPhyHelper::Default();
 	wifiPhy.SetChannel(wifiChannel.Create());
@@ -96,24 +351,30 @@ void Stratos::CreateDevices() {
 	wifiMac.SetType("ns3::AdhocWifiMac");
 	WifiHelper wifi = WifiHelper::Default();
 	wifiDevices = wifi.Install(wifiPhy, wifiMac, wifiNodes);
+	nextStream += wifi.AssignStreams(wifiDevices, nextStream);
+	ReportPhase("CreateDevices", start);
 }
 
 void Stratos::InstallInternetStack() {
 	NS_LOG_FUNCTION(this);
+	double start = Utilities::GetWallClockTime();
 	InternetStackHelper internetStack;
 	AodvHelper aodv;
 	internetStack.SetRoutingHelper(aodv);
 	internetStack.Install(wifiNodes);
+	nextStream += aodv.AssignStreams(wifiNodes, nextStream);
 	Ipv4AddressHelper addressHelper;
 	addressHelper.SetBase("10.0.0.0", "255.0.0.0");
 	addressHelper.Assign(wifiDevices);
+	ReportPhase("InstallInternetStack", start);
 }
 
 void Stratos::InstallApplications() {
 	NS_LOG_FUNCTION(this);
+	double start = Utilities::GetWallClockTime();
 	Ptr<Node> centralNode = wifiNodes.Get(0);
 	NodeContainer nodes;
-	for(int i = 1; i < TOTAL_NUMBER_OF_NODES; i++) {
+	for(int i = 1; i < NUMBER_OF_NODES; i++) {
 		nodes.Add(wifiNodes.Get(i));
 	}
 	ApplicationContainer applications;
@@ -124,27 +385,56 @@ void Stratos::InstallApplications() {
 	applications.Add(position.Install(wifiNodes));
 	SearchHelper search;
 	search.SetAttribute("centralServerAddress", UintegerValue(centralNode->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal().Get()));
+	search.SetAttribute("adaptiveTimers", BooleanValue(ADAPTIVE_TIMERS));
+	search.SetAttribute("deltaNotifications", BooleanValue(DELTA_NOTIFICATIONS));
+	search.SetAttribute("notificationDistance", DoubleValue(NOTIFICATION_DISTANCE_THRESHOLD));
+	search.SetAttribute("keepaliveTime", DoubleValue(KEEPALIVE_INTERVAL));
+	search.SetAttribute("velocityNotifications", BooleanValue(VELOCITY_NOTIFICATIONS));
 	applications.Add(search.Install(nodes));
 	ServiceHelper service;
 	service.SetAttribute("nPackets", IntegerValue(NUMBER_OF_PACKETS_TO_SEND));
+	service.SetAttribute("window", IntegerValue(SERVICE_WINDOW_SIZE));
+	service.SetAttribute("adaptiveTimers", BooleanValue(ADAPTIVE_TIMERS));
 	applications.Add(service.Install(nodes));
 	ResultsHelper results;
 	applications.Add(results.Install(nodes));
 	CentralHelper central;
 	central.SetAttribute("nSchedule", IntegerValue(MAX_SCHEDULE_SIZE));
+	central.SetAttribute("spatialIndex", BooleanValue(USE_SPATIAL_INDEX));
+	central.SetAttribute("topKSelection", BooleanValue(USE_TOP_K_SELECTION));
+	central.SetAttribute("serviceIndex", BooleanValue(USE_SERVICE_INDEX));
+	central.SetAttribute("predictionMargin", DoubleValue(PREDICTION_MARGIN));
+	central.SetAttribute("expiry", DoubleValue(EXPIRY));
+	central.SetAttribute("maxSpeed", DoubleValue(MAX_SPEED));
 	applications.Add(central.Install(centralNode));
 	ScheduleHelper schedule;
 	schedule.SetAttribute("nSchedule", IntegerValue(MAX_SCHEDULE_SIZE));
+	schedule.SetAttribute("parallel", BooleanValue(PARALLEL_SCHEDULE));
 	applications.Add(schedule.Install(nodes));
 	applications.Start(Seconds(1));
 	applications.Stop(Seconds(TOTAL_SIMULATION_TIME - 1));
+	ReportPhase("InstallApplications", start);
+}
+
+void Stratos::CheckParameters() {
+	NS_LOG_FUNCTION(this);
+	NS_ABORT_MSG_IF(NUMBER_OF_NODES < 2, "At least a central and another node are needed, got " << NUMBER_OF_NODES);
+	NS_ABORT_MSG_IF(NUMBER_OF_MOBILE_NODES < 0 || NUMBER_OF_MOBILE_NODES > NUMBER_OF_NODES, "Number of mobile nodes must be between 0 and " << NUMBER_OF_NODES);
+	NS_ABORT_MSG_IF(NUMBER_OF_REQUESTER_NODES < 1 || NUMBER_OF_REQUESTER_NODES > NUMBER_OF_NODES - 2, "Number of requester nodes must be between 1 and " << NUMBER_OF_NODES - 2);
+	NS_ABORT_MSG_IF(AREA_SIZE < 0, "Area size must be positive, got " << AREA_SIZE);
+	//Nodes notify every one to two hello periods, or only at their keepalives when sending deltas and idle
+	double maxSilence = 2 * HELLO_TIME + (DELTA_NOTIFICATIONS ? KEEPALIVE_INTERVAL : 0);
+	NS_ABORT_MSG_IF(EXPIRY < 0 || (EXPIRY > 0 && EXPIRY * HELLO_TIME <= maxSilence), "Expiry must be 0 or longer than " << maxSilence / HELLO_TIME << " hello periods, got " << EXPIRY);
+	NS_ABORT_MSG_IF(!(MAX_SPEED >= 0), "Max speed must be positive, got " << MAX_SPEED);
+	//Periodic notifications resend the first one, so its velocity would be extrapolated from where the node started
+	NS_ABORT_MSG_IF(VELOCITY_NOTIFICATIONS && !DELTA_NOTIFICATIONS, "Velocity notifications need delta notifications");
 }
 
 void Stratos::CreateMobileNodes() {
 	NS_LOG_FUNCTION(this);
 	int nMobileNodes;
-	if(NUMBER_OF_MOBILE_NODES == TOTAL_NUMBER_OF_NODES) {
-		nMobileNodes = TOTAL_NUMBER_OF_NODES - 1;
+	if(NUMBER_OF_MOBILE_NODES == NUMBER_OF_NODES) {
+		nMobileNodes = NUMBER_OF_NODES - 1;
 	} else {
 		nMobileNodes = NUMBER_OF_MOBILE_NODES;
 	}
@@ -163,15 +453,16 @@ void Stratos::CreateMobileNodes() {
 							"Speed", StringValue("ns3::UniformRandomVariable[Min=1|Max=4]"), //[1m/s, 4m/s]
 							"Pause", StringValue("ns3::ConstantRandomVariable[Constant=40]")); //40s
 	mobility.Install(mobileNodes);
+	nextStream += mobility.AssignStreams(mobileNodes, nextStream);
 }
 
 void Stratos::CreateStaticNodes() {
 	NS_LOG_FUNCTION(this);
 	int nStaticNodes;
-	if(NUMBER_OF_MOBILE_NODES == TOTAL_NUMBER_OF_NODES) {
+	if(NUMBER_OF_MOBILE_NODES == NUMBER_OF_NODES) {
 		nStaticNodes = 1;
 	} else {
-		nStaticNodes = TOTAL_NUMBER_OF_NODES - NUMBER_OF_MOBILE_NODES;
+		nStaticNodes = NUMBER_OF_NODES - NUMBER_OF_MOBILE_NODES;
 	}
 	NS_LOG_DEBUG("Creating " << nStaticNodes << " static nodes");
 	staticNodes.Create(nStaticNodes);
@@ -187,13 +478,27 @@ void Stratos::CreateStaticNodes() {
 	mobility.Install(staticNodes);
 }
 
+/*
+ * Each allocator draws from its own variable on a stream of its own, so neither the bounds set here
+ * nor mobility.AssignStreams touch the cached streams of Utilities.
+ */
 Ptr<PositionAllocator> Stratos::GetPositionAllocator() {
 	NS_LOG_FUNCTION(this);
 	Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable>();
+	random->SetStream(nextStream++);
 	random->SetAttribute("Min", DoubleValue(0));
-	random->SetAttribute("Max", DoubleValue(MAX_DISTANCE));
+	random->SetAttribute("Max", DoubleValue(AREA_SIZE));
 	Ptr<RandomRectanglePositionAllocator> positionAllocator = CreateObject<RandomRectanglePositionAllocator>();
 	positionAllocator->SetX(random);
 	positionAllocator->SetY(random);
 	return positionAllocator;
+}
+
+void Stratos::ReportPhase(std::string phase, double start) {
+	NS_LOG_FUNCTION(this << phase << start);
+	double elapsed = Utilities::GetWallClockTime() - start;
+	NS_LOG_INFO(phase << " took " << elapsed << "s, peak resident memory = " << Utilities::GetPeakResidentMemory() << "KB");
+	if(PROFILE) {
+		std::clog << phase << "|" << NUMBER_OF_NODES << "|" << elapsed << "|" << Utilities::GetPeakResidentMemory() << std::endl;
+	}
 }
\ No newline at end of file
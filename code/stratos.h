@@ -15,23 +15,76 @@ class Stratos {
 		NetDeviceContainer wifiDevices;
 
 		int MAX_SCHEDULE_SIZE;
+		int NUMBER_OF_NODES;
 		int NUMBER_OF_MOBILE_NODES;
 		int NUMBER_OF_PACKETS_TO_SEND;
+		int SERVICE_WINDOW_SIZE;
+		bool PARALLEL_SCHEDULE;
+		bool ADAPTIVE_TIMERS;
+		bool DELTA_NOTIFICATIONS;
+		double NOTIFICATION_DISTANCE_THRESHOLD;
+		double KEEPALIVE_INTERVAL;
+		bool VELOCITY_NOTIFICATIONS;
+		double PREDICTION_MARGIN;
+		double EXPIRY;
+		double MAX_SPEED;
+		double ORIGIN_X;
+		double ORIGIN_Y;
+		double AREA_SIZE;
+		int SEED;
+		int RUN;
+		int64_t nextStream;
+		bool PROFILE;
 		int NUMBER_OF_REQUESTER_NODES;
 		int NUMBER_OF_SERVICES_OFFERED;
+		bool USE_SPATIAL_INDEX;
+		bool USE_TOP_K_SELECTION;
+		bool USE_SERVICE_INDEX;
+		std::string CATALOG;
+		std::string BENCHMARK;
+		std::string BENCHMARK_SIZES;
+		bool SERVER;
+		int SERVER_PORT;
+		int NUMBER_OF_SERVER_THREADS;
+		bool LOAD;
+		std::string LOAD_NODES;
+		std::string LOAD_SCHEDULES;
+		int NUMBER_OF_LOAD_REQUESTS;
+		double LOAD_NOTIFICATIONS;
+		std::string LOAD_SERVER;
+		bool SWEEP;
+		std::string SWEEP_SCHEDULE;
+		std::string SWEEP_MOBILE;
+		std::string SWEEP_REQUESTERS;
+		std::string SWEEP_PACKETS;
+		std::string SWEEP_SERVICES;
+		std::string SWEEP_NAME;
+		std::string SWEEP_DIRECTORY;
+		int NUMBER_OF_SWEEP_RUNS;
+		int NUMBER_OF_SWEEP_WORKERS;
 
 	public:
 		Stratos(int argc, char *argv[]);
 		void Run();
+		bool IsBenchmark();
+		int RunBenchmark();
+		bool IsServer();
+		void RunServer();
+		bool IsLoad();
+		void RunLoad();
+		bool IsSweep();
+		int RunSweep();
 		void CreateNodes();
 		void CreateDevices();
 		void InstallInternetStack();
 		void InstallApplications();
 
 	private:
+		void CheckParameters();
 		void CreateMobileNodes();
 		void CreateStaticNodes();
 		Ptr<PositionAllocator> GetPositionAllocator();
+		void ReportPhase(std::string phase, double start);
 };
 
 #endif
\ No newline at end of file
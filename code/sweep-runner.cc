@@ -0,0 +1,124 @@
+#include "sweep-runner.h"
+
+#include "ns3/core-module.h"
+
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <fstream>
+#include <iostream>
+#include <unistd.h>
+#include <sys/wait.h>
+
+NS_LOG_COMPONENT_DEFINE("SweepRunner");
+
+SweepRunner::SweepRunner(std::string directory, std::string name, int nWorkers) {
+	NS_LOG_FUNCTION(this << directory << name << nWorkers);
+	this->directory = directory;
+	this->name = name;
+	if(nWorkers <= 0) {
+		nWorkers = sysconf(_SC_NPROCESSORS_ONLN);
+	}
+	this->nWorkers = nWorkers > 0 ? nWorkers : 1;
+	nJobs = 0;
+	nFailed = 0;
+}
+
+std::string SweepRunner::GetFileName(SWEEP_JOB job) {
+	NS_LOG_FUNCTION(this << job.parameter << job.value);
+	std::ostringstream fileName;
+	fileName << directory << "/centralized_" << (name.empty() ? job.parameter : name) << "_" << job.value << ".txt";
+	return fileName.str();
+}
+
+void SweepRunner::Collect(pid_t pid, int status) {
+	NS_LOG_FUNCTION(this << pid << status);
+	std::map<pid_t, std::pair<SWEEP_JOB, FILE *> >::iterator i = running.find(pid);
+	if(i == running.end()) {
+		return;
+	}
+	SWEEP_JOB job = i->second.first;
+	FILE *output = i->second.second;
+	running.erase(i);
+	if(!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+		//A partial output would shift the lines of every later simulation in the file
+		std::cerr << "Simulation " << job.run << " with " << job.parameter << " = " << job.value << " failed, its output is discarded" << std::endl;
+		nFailed++;
+		fclose(output);
+		return;
+	}
+	std::ofstream file(GetFileName(job).c_str(), std::ios::app);
+	rewind(output);
+	char buffer[4096];
+	size_t size;
+	while((size = fread(buffer, 1, sizeof(buffer), output)) > 0) {
+		file.write(buffer, size);
+	}
+	fclose(output);
+	NS_LOG_INFO("Simulation " << job.run << " with " << job.parameter << " = " << job.value << " appended to " << GetFileName(job));
+}
+
+void SweepRunner::AddJob(SWEEP_JOB job) {
+	NS_LOG_FUNCTION(this << job.parameter << job.value << job.run);
+	pending.push_back(job);
+	nJobs++;
+}
+
+/*
+ * Returns false in the parent once every job finished. Returns true in a forked worker, with
+ * its job and stdout redirected to the buffer of the job, which has to call Finish when done.
+ */
+bool SweepRunner::Run(SWEEP_JOB &job) {
+	NS_LOG_FUNCTION(this);
+	while(!pending.empty() || !running.empty()) {
+		if(!pending.empty() && (int) running.size() < nWorkers) {
+			SWEEP_JOB next = pending.front();
+			pending.pop_front();
+			FILE *output = tmpfile();
+			if(output == NULL) {
+				std::cerr << "Cannot buffer the output of simulation " << next.run << ": " << strerror(errno) << std::endl;
+				nFailed++;
+				continue;
+			}
+			//Otherwise buffered output of the parent would be written again by the worker
+			std::cout.flush();
+			fflush(stdout);
+			pid_t pid = fork();
+			if(pid == 0) {
+				dup2(fileno(output), STDOUT_FILENO);
+				job = next;
+				return true;
+			}
+			if(pid < 0) {
+				std::cerr << "Cannot fork simulation " << next.run << ": " << strerror(errno) << std::endl;
+				nFailed++;
+				fclose(output);
+				continue;
+			}
+			NS_LOG_INFO("Simulation " << next.run << " with " << next.parameter << " = " << next.value << " started by worker " << pid);
+			running[pid] = std::make_pair(next, output);
+			continue;
+		}
+		int status;
+		pid_t pid = waitpid(-1, &status, 0);
+		if(pid > 0) {
+			Collect(pid, status);
+		} else if(errno != EINTR) {
+			break;
+		}
+	}
+	NS_LOG_INFO("Sweep finished, " << nJobs - nFailed << " of " << nJobs << " simulations succeeded");
+	return false;
+}
+
+void SweepRunner::Finish() {
+	NS_LOG_FUNCTION(this);
+	std::cout.flush();
+	fflush(stdout);
+	_exit(0);
+}
+
+int SweepRunner::GetFailedJobs() {
+	NS_LOG_FUNCTION(this);
+	return nFailed;
+}
\ No newline at end of file
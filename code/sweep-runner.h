@@ -0,0 +1,43 @@
+#ifndef SWEEP_RUNNER_H
+#define SWEEP_RUNNER_H
+
+#include <map>
+#include <list>
+#include <string>
+#include <cstdio>
+#include <sys/types.h>
+
+#include "definitions.h"
+
+/*
+ * Runs the simulations of a parameter sweep on a pool of worker processes. The simulator
+ * is global state, so every simulation needs its own process, but forking them from the
+ * configured program avoids paying waf and ns-3 startup on each one. The output of every
+ * simulation is buffered and appended whole to the file of its configuration, so runs
+ * finishing at the same time never interleave their lines.
+ */
+class SweepRunner {
+
+	public:
+		SweepRunner(std::string directory, std::string name, int nWorkers);
+
+	private:
+		std::string directory;
+		std::string name;
+		int nWorkers;
+		int nJobs;
+		int nFailed;
+		std::list<SWEEP_JOB> pending;
+		std::map<pid_t, std::pair<SWEEP_JOB, FILE *> > running;
+
+		std::string GetFileName(SWEEP_JOB job);
+		void Collect(pid_t pid, int status);
+
+	public:
+		void AddJob(SWEEP_JOB job);
+		bool Run(SWEEP_JOB &job);
+		void Finish();
+		int GetFailedJobs();
+};
+
+#endif
\ No newline at end of file
@@ -41,6 +41,9 @@ void TypeHeader::Print(std::ostream &stream) const {
 		case STRATOS_SEARCH_NOTIFICATION:
 			stream << "Search Notification Message";
 			break;
+		case STRATOS_SEARCH_NOTIFICATION_DELTA:
+			stream << "Search Notification Delta Message";
+			break;
 		default:
 			stream << "Unknown Message";
 	}
@@ -59,6 +62,7 @@ uint32_t TypeHeader::Deserialize(Buffer::Iterator start) {
 		case STRATOS_SERVICE_RESPONSE:
 		case STRATOS_SERVICE_ERROR:
 		case STRATOS_SEARCH_NOTIFICATION:
+		case STRATOS_SEARCH_NOTIFICATION_DELTA:
 			this->messageType = (MessageType) messageType;
 			break;
 		default:
@@ -2,17 +2,56 @@
 
 #include "definitions.h"
 
+#include <fstream>
+#include <unistd.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+
+/*
+ * Every subsystem draws from its own cached stream with a fixed index, so a seed and run
+ * reproduce a simulation, and a change in how often one subsystem draws does not shift
+ * the numbers another one gets. Streams are created on first use, after the run is set.
+ */
+ns3::Ptr<ns3::UniformRandomVariable> Utilities::streams[NUMBER_OF_RANDOM_STREAMS];
+
 double Utilities::GetJitter() {
-	return Random(MIN_JITTER, MAX_JITTER);
+	return Random(MIN_JITTER, MAX_JITTER, STRATOS_JITTER_STREAM);
 }
 
 double Utilities::GetCurrentRawDateTime() {
 	return ns3::Now().GetMilliSeconds();
 }
 
-double Utilities::Random(double min, double max) {
-	ns3::Ptr<ns3::UniformRandomVariable> random = ns3::CreateObject<ns3::UniformRandomVariable>();
-	return random->GetValue(min, max);
+double Utilities::GetWallClockTime() {
+	struct timeval now;
+	gettimeofday(&now, NULL);
+	return now.tv_sec + now.tv_usec / 1000000.0;
+}
+
+long Utilities::GetResidentMemory() {
+	long size = 0;
+	long resident = 0;
+	std::ifstream statm("/proc/self/statm");
+	statm >> size >> resident;
+	return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+long Utilities::GetPeakResidentMemory() {
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	return usage.ru_maxrss; //KB on Linux
+}
+
+ns3::Ptr<ns3::UniformRandomVariable> Utilities::GetStream(RandomStream stream) {
+	if(streams[stream] == NULL) {
+		streams[stream] = ns3::CreateObject<ns3::UniformRandomVariable>();
+		streams[stream]->SetStream(stream);
+	}
+	return streams[stream];
+}
+
+double Utilities::Random(double min, double max, RandomStream stream) {
+	return GetStream(stream)->GetValue(min, max);
 }
 
 double Utilities::GetSecondsElapsedSinceUntil(double since, double until) {
@@ -3,13 +3,22 @@
 
 #include "ns3/core-module.h"
 
+#include "definitions.h"
+
 class Utilities {
 
 	public:
 		static double GetJitter();
 		static double GetCurrentRawDateTime();
-		static double Random(double min, double max);
+		static double GetWallClockTime();
+		static long GetResidentMemory();
+		static long GetPeakResidentMemory();
+		static ns3::Ptr<ns3::UniformRandomVariable> GetStream(RandomStream stream);
+		static double Random(double min, double max, RandomStream stream = STRATOS_WORKLOAD_STREAM);
 		static double GetSecondsElapsedSinceUntil(double since, double until);
+
+	private:
+		static ns3::Ptr<ns3::UniformRandomVariable> streams[NUMBER_OF_RANDOM_STREAMS];
 };
 
 #endif
\ No newline at end of file
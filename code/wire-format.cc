@@ -0,0 +1,79 @@
+#include "wire-format.h"
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#define FIXED_POINT_ONE 65536.0
+
+#define UNKNOWN_DISTANCE 0xFFFFFFFF
+
+POSITION WireFormat::origin = {0, 0};
+
+uint32_t WireFormat::Saturate(double value, double min, double max) {
+	//Values out of range saturate instead of wrapping around
+	double rounded = floor(value + 0.5);
+	rounded = std::max(min, std::min(rounded, max));
+	return (uint32_t) (int64_t) rounded;
+}
+
+uint32_t WireFormat::ToFixedPoint(double value, double min, double max) {
+	return Saturate(value * FIXED_POINT_ONE, min, max);
+}
+
+POSITION WireFormat::GetOrigin() {
+	return origin;
+}
+
+void WireFormat::SetOrigin(POSITION origin) {
+	WireFormat::origin = origin;
+}
+
+void WireFormat::WritePosition(Buffer::Iterator &serializer, POSITION position) {
+	serializer.WriteHtonU32(ToFixedPoint(position.x - origin.x, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max()));
+	serializer.WriteHtonU32(ToFixedPoint(position.y - origin.y, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max()));
+}
+
+POSITION WireFormat::ReadPosition(Buffer::Iterator &i) {
+	POSITION position;
+	position.x = origin.x + (int32_t) i.ReadNtohU32() / FIXED_POINT_ONE;
+	position.y = origin.y + (int32_t) i.ReadNtohU32() / FIXED_POINT_ONE;
+	return position;
+}
+
+void WireFormat::WriteDistance(Buffer::Iterator &serializer, double distance) {
+	if(distance == std::numeric_limits<double>::max()) {
+		serializer.WriteHtonU32(UNKNOWN_DISTANCE);
+		return;
+	}
+	serializer.WriteHtonU32(ToFixedPoint(distance, 0, UNKNOWN_DISTANCE - 1.0));
+}
+
+double WireFormat::ReadDistance(Buffer::Iterator &i) {
+	uint32_t distance = i.ReadNtohU32();
+	if(distance == UNKNOWN_DISTANCE) {
+		return std::numeric_limits<double>::max();
+	}
+	return distance / FIXED_POINT_ONE;
+}
+
+void WireFormat::WriteVelocity(Buffer::Iterator &serializer, VELOCITY velocity) {
+	serializer.WriteHtonU32(Saturate(velocity.x * VELOCITY_SCALE, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max()));
+	serializer.WriteHtonU32(Saturate(velocity.y * VELOCITY_SCALE, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max()));
+}
+
+VELOCITY WireFormat::ReadVelocity(Buffer::Iterator &i) {
+	VELOCITY velocity;
+	velocity.x = (double) ((int32_t) i.ReadNtohU32()) / VELOCITY_SCALE;
+	velocity.y = (double) ((int32_t) i.ReadNtohU32()) / VELOCITY_SCALE;
+	return velocity;
+}
+
+void WireFormat::WriteTimestamp(Buffer::Iterator &serializer, double timestamp) {
+	//Timestamps are in milliseconds
+	serializer.WriteHtonU64((uint64_t) (int64_t) floor(timestamp * 1000 + 0.5));
+}
+
+double WireFormat::ReadTimestamp(Buffer::Iterator &i) {
+	return (int64_t) i.ReadNtohU64() / 1000.0;
+}
\ No newline at end of file
@@ -0,0 +1,39 @@
+#ifndef WIRE_FORMAT_H
+#define WIRE_FORMAT_H
+
+#include "ns3/header.h"
+
+#include "definitions.h"
+
+using namespace ns3;
+
+/*
+ * Encoding of geometry and time shared by the search headers.
+ * Coordinates are signed 16.16 fixed point meters relative to an origin that both ends must agree on,
+ * which covers +-32768m around it in steps of 1/65536m. Distances are unsigned 16.16 fixed point,
+ * with the all-ones value standing for an unknown distance. Velocities are signed 32-bit VELOCITY_SCALE
+ * units per second, and timestamps are 64-bit microseconds. Every field is in network byte order.
+ */
+class WireFormat {
+
+	private:
+		static POSITION origin;
+
+		static uint32_t Saturate(double value, double min, double max);
+		static uint32_t ToFixedPoint(double value, double min, double max);
+
+	public:
+		static POSITION GetOrigin();
+		static void SetOrigin(POSITION origin);
+
+		static void WritePosition(Buffer::Iterator &serializer, POSITION position);
+		static POSITION ReadPosition(Buffer::Iterator &i);
+		static void WriteDistance(Buffer::Iterator &serializer, double distance);
+		static double ReadDistance(Buffer::Iterator &i);
+		static void WriteVelocity(Buffer::Iterator &serializer, VELOCITY velocity);
+		static VELOCITY ReadVelocity(Buffer::Iterator &i);
+		static void WriteTimestamp(Buffer::Iterator &serializer, double timestamp);
+		static double ReadTimestamp(Buffer::Iterator &i);
+};
+
+#endif
\ No newline at end of file
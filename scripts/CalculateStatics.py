@@ -134,4 +134,20 @@ CalculateStatics("stratos/centralized_packets_20.txt", 20)
 CalculateStatics("stratos/centralized_packets_40.txt", 40)
 CalculateStatics("stratos/centralized_packets_60.txt", 60)
 print("", file=staticsFile)
+CalculateStatics("stratos/centralized_window_40.txt", 40)
+CalculateStatics("stratos/centralized_window_60.txt", 60)
+print("", file=staticsFile)
+CalculateStatics("stratos/centralized_parallel_40.txt", 40)
+CalculateStatics("stratos/centralized_parallel_60.txt", 60)
+print("", file=staticsFile)
+CalculateStatics("stratos/centralized_delta_40.txt", 40)
+CalculateStatics("stratos/centralized_delta_60.txt", 60)
+print("", file=staticsFile)
+CalculateStatics("stratos/centralized_prediction_40.txt", 40)
+CalculateStatics("stratos/centralized_prediction_60.txt", 60)
+print("", file=staticsFile)
+CalculateStatics("stratos/centralized_nodes_1000.txt", 20)
+CalculateStatics("stratos/centralized_nodes_5000.txt", 20)
+CalculateStatics("stratos/centralized_nodes_10000.txt", 20)
+print("", file=staticsFile)
 staticsFile.close()
\ No newline at end of file